@@ -23,6 +23,9 @@
 #include "ns3/network-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "health-producer-ext.hpp"
+#include "health-scenario-options.hpp"
+
 namespace ns3 {
 
 /**
@@ -50,7 +53,12 @@ namespace ns3 {
 int
 main(int argc, char* argv[])
 {
+  std::string producerApp = "ns3::ndn::HealthProducer";
+
+  ndn::ScenarioOptions options;
   CommandLine cmd;
+  cmd.AddValue("producerApp", "Producer application type (e.g. ns3::ndn::HealthProducerExt)", producerApp);
+  options.AddOptions(cmd);
   cmd.Parse(argc, argv);
 
   AnnotatedTopologyReader topologyReader("", 25);
@@ -211,7 +219,7 @@ main(int argc, char* argv[])
   consumerHelper.SetPrefix("/Pat3");
   consumerHelper.Install(consumer24);
 
-  ndn::AppHelper producerHelper("ns3::ndn::HealthProducer");
+  ndn::AppHelper producerHelper(producerApp);
   producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
 
   // Register /dst1 prefix with global routing controller and
@@ -274,10 +282,12 @@ main(int argc, char* argv[])
   // Calculate and install FIBs
   ndn::GlobalRoutingHelper::CalculateRoutes();
 
-  Simulator::Stop(Seconds(50.0));
+  if (!options.InstallInstrumentation(Seconds(50.0))) {
+    Simulator::Destroy();
+    return 0;
+  }
 
-  ndn::AppDelayTracer::InstallAll("app-delays.txt");
-  Simulator::Run();
+  options.Run();
   Simulator::Destroy();
 
   return 0;
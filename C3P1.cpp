@@ -23,6 +23,11 @@
 #include "ns3/network-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "consumer-health-window.hpp"
+#include "health-load-balancer-strategy.hpp"
+#include "health-producer-ext.hpp"
+#include "health-scenario-options.hpp"
+
 namespace ns3 {
 
 /**
@@ -50,7 +55,14 @@ namespace ns3 {
 int
 main(int argc, char* argv[])
 {
+  uint32_t backlog = 0;
+  std::string producerApp = "ns3::ndn::HealthProducer";
+
+  ndn::ScenarioOptions options;
   CommandLine cmd;
+  cmd.AddValue("backlog", "Number of past readings each doctor catches up on (0 = none)", backlog);
+  cmd.AddValue("producerApp", "Producer application type (e.g. ns3::ndn::HealthProducerExt)", producerApp);
+  options.AddOptions(cmd);
   cmd.Parse(argc, argv);
 
   AnnotatedTopologyReader topologyReader("", 25);
@@ -67,6 +79,9 @@ main(int argc, char* argv[])
   // Choosing forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/best-route");
 
+  // Spread interests over the replica producers of each prefix
+  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::HealthLoadBalancerStrategy>("/Pat1");
+
   // Installing global routing interface on all nodes
   ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll();
@@ -100,7 +115,19 @@ main(int argc, char* argv[])
   consumerHelper.SetPrefix("/Pat1");
   consumerHelper.Install(consumer3);
 
-  ndn::AppHelper producerHelper("ns3::ndn::HealthProducer");
+  if (backlog > 0) {
+    // doctors that just reconnected fetch the reading history with a pipelined window
+    // (slow start + AIMD) instead of the fixed polling rate
+    ndn::AppHelper backlogHelper("ns3::ndn::ConsumerHealthWindow");
+    backlogHelper.SetAttribute("InitialWindow", StringValue("1"));
+    backlogHelper.SetAttribute("MaxSeq", IntegerValue(backlog));
+    backlogHelper.SetPrefix("/Pat1");
+    backlogHelper.Install(consumer1);
+    backlogHelper.Install(consumer2);
+    backlogHelper.Install(consumer3);
+  }
+
+  ndn::AppHelper producerHelper(producerApp);
   producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
 
   // Register /dst1 prefix with global routing controller and
@@ -127,10 +154,12 @@ main(int argc, char* argv[])
   // Calculate and install FIBs
   ndn::GlobalRoutingHelper::CalculateRoutes();
 
-  Simulator::Stop(Seconds(50.0));
+  if (!options.InstallInstrumentation(Seconds(50.0))) {
+    Simulator::Destroy();
+    return 0;
+  }
 
-  ndn::AppDelayTracer::InstallAll("app-delays.txt");
-  Simulator::Run();
+  options.Run();
   Simulator::Destroy();
 
   return 0;
@@ -23,6 +23,12 @@
 #include "ns3/network-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "consumer-health-multi.hpp"
+#include "consumer-health-object.hpp"
+#include "health-object-delay-tracer.hpp"
+#include "health-producer-ext.hpp"
+#include "health-scenario-options.hpp"
+
 namespace ns3 {
 
 /**
@@ -50,11 +56,37 @@ namespace ns3 {
 int
 main(int argc, char* argv[])
 {
+  std::string producerApp = "ns3::ndn::HealthProducer";
+  bool multiConsumer = false;
+  bool acuityScaling = false;
+  bool multiDevice = false;
+  uint32_t objectSize = 0;
+
+  ndn::ScenarioOptions options;
   CommandLine cmd;
+  cmd.AddValue("producerApp", "Producer application type (e.g. ns3::ndn::HealthProducerExt)", producerApp);
+  cmd.AddValue("multiConsumer", "Serve each doctor's patient list from one consumer", multiConsumer);
+  cmd.AddValue("acuityScaling", "With multiConsumer, poll sicker patients more often at the same total rate",
+               acuityScaling);
+  cmd.AddValue("multiDevice", "Emulate all devices of a patient in one producer on the patient node", multiDevice);
+  cmd.AddValue("objectSize",
+               "Publish DataType 4 readings as segmented objects of this many bytes (uses HealthProducerExt)",
+               objectSize);
+  options.AddOptions(cmd);
   cmd.Parse(argc, argv);
 
+  if (acuityScaling && !multiConsumer) {
+    NS_FATAL_ERROR("--acuityScaling needs --multiConsumer");
+  }
+
+  if (objectSize > 0) {
+    // only HealthProducerExt publishes segmented objects
+    producerApp = "ns3::ndn::HealthProducerExt";
+  }
+
   AnnotatedTopologyReader topologyReader("", 25);
-  topologyReader.SetFileName("src/ndnSIM/examples/topologies/C3P3.txt");
+  topologyReader.SetFileName(multiDevice ? "src/ndnSIM/examples/topologies/C3P3-multi-device.txt"
+                                         : "src/ndnSIM/examples/topologies/C3P3.txt");
   topologyReader.Read();
 
   // Install NDN stack on all nodes
@@ -86,110 +118,196 @@ main(int argc, char* argv[])
   Ptr<Node> producer8 = Names::Find<Node>("Dev2Pat3");
   Ptr<Node> producer9 = Names::Find<Node>("Dev3Pat3");
 
-  ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealth");
-  consumerHelper.SetAttribute("Frequency", StringValue("5")); // 5 interests a second
-  consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
-
-  // on the first consumer node install a Consumer application
-  // that will express interests in /dst1 namespace
-  consumerHelper.SetAttribute("Seed", StringValue("3"));
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer3);
-  
-  consumerHelper.SetAttribute("Seed", StringValue("7"));
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer3);
-
-  consumerHelper.SetAttribute("Seed", StringValue("5"));
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer3);
-
-
-  ndn::AppHelper producerHelper("ns3::ndn::HealthProducer");
-  producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
-
-  // Register /dst1 prefix with global routing controller and
-  // install producer that will satisfy Interests in /dst1 namespace
-  ndnGlobalRoutingHelper.AddOrigins("Pat1/Dev1", producer1);
-  producerHelper.SetPrefix("Pat1/Dev1");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("1"));
-  producerHelper.Install(producer1);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat1/Dev2", producer2);
-  producerHelper.SetPrefix("/Pat1/Dev2");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("3"));
-  producerHelper.Install(producer2);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat1/Dev3", producer3);
-  producerHelper.SetPrefix("/Pat1/Dev3");
-  producerHelper.SetAttribute("DataType", StringValue("4"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("2"));
-  producerHelper.Install(producer3);
-
-  ndnGlobalRoutingHelper.AddOrigins("Pat2/Dev1", producer4);
-  producerHelper.SetPrefix("Pat2/Dev1");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("1"));
-  producerHelper.Install(producer4);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat2/Dev2", producer5);
-  producerHelper.SetPrefix("/Pat2/Dev2");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("5"));
-  producerHelper.Install(producer5);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat2/Dev3", producer6);
-  producerHelper.SetPrefix("/Pat2/Dev3");
-  producerHelper.SetAttribute("DataType", StringValue("4"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("2"));
-  producerHelper.Install(producer6);
-
-  ndnGlobalRoutingHelper.AddOrigins("Pat3/Dev1", producer7);
-  producerHelper.SetPrefix("Pat3/Dev1");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("4"));
-  producerHelper.Install(producer7);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat3/Dev2", producer8);
-  producerHelper.SetPrefix("/Pat3/Dev2");
-  producerHelper.SetAttribute("DataType", StringValue("2"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("5"));
-  producerHelper.Install(producer8);
-
-  ndnGlobalRoutingHelper.AddOrigins("/Pat3/Dev3", producer9);
-  producerHelper.SetPrefix("/Pat3/Dev3");
-  producerHelper.SetAttribute("DataType", StringValue("4"));
-  producerHelper.SetAttribute("DiseaseRank", StringValue("3"));
-  producerHelper.Install(producer9);
+  if (multiConsumer) {
+    // one consumer application per doctor polls the whole patient list
+    ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealthMulti");
+    consumerHelper.SetAttribute("Prefixes", StringValue("/Pat1/Dev1 /Pat1/Dev2 /Pat1/Dev3 "
+                                                        "/Pat2/Dev1 /Pat2/Dev2 /Pat2/Dev3 "
+                                                        "/Pat3/Dev1 /Pat3/Dev2 /Pat3/Dev3"));
+    // 5 interests a second per patient, spread over its 3 devices, as in the
+    // one-consumer-per-patient setup below
+    consumerHelper.SetAttribute("Frequency", DoubleValue(5.0 / 3));
+    consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
+    consumerHelper.SetAttribute("Seed", StringValue("3"));
+    consumerHelper.SetAttribute("RankScaling", StringValue(acuityScaling ? "true" : "false"));
+    // the DiseaseRank of each producer below: ranks are only learned from
+    // HealthProducerExt content, and the default HealthProducer has none
+    consumerHelper.SetAttribute("Ranks", StringValue("/Pat1/Dev1:1 /Pat1/Dev2:3 /Pat1/Dev3:2 "
+                                                     "/Pat2/Dev1:1 /Pat2/Dev2:5 /Pat2/Dev3:2 "
+                                                     "/Pat3/Dev1:4 /Pat3/Dev2:5 /Pat3/Dev3:3"));
+    consumerHelper.Install(consumer1);
+    consumerHelper.Install(consumer2);
+    consumerHelper.Install(consumer3);
+  }
+  else {
+    ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealth");
+    consumerHelper.SetAttribute("Frequency", StringValue("5")); // 5 interests a second
+    consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
+
+    // on the first consumer node install a Consumer application
+    // that will express interests in /dst1 namespace
+    consumerHelper.SetAttribute("Seed", StringValue("3"));
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("7"));
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("5"));
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer3);
+  }
+
+  if (objectSize > 0) {
+    // doctors also pull the DataType 4 records as segmented objects, 8 segments in flight
+    ndn::AppHelper objectHelper("ns3::ndn::ConsumerHealthObject");
+    objectHelper.SetAttribute("Frequency", StringValue("0.2")); // one object every 5 seconds
+    objectHelper.SetAttribute("Randomize", StringValue("exponential"));
+    objectHelper.SetAttribute("Pipeline", StringValue("8"));
+
+    objectHelper.SetAttribute("Seed", StringValue("3"));
+    objectHelper.SetPrefix("/Pat1/Dev3");
+    objectHelper.Install(consumer1);
+    objectHelper.Install(consumer2);
+    objectHelper.Install(consumer3);
+
+    objectHelper.SetAttribute("Seed", StringValue("7"));
+    objectHelper.SetPrefix("/Pat2/Dev3");
+    objectHelper.Install(consumer1);
+    objectHelper.Install(consumer2);
+    objectHelper.Install(consumer3);
+
+    objectHelper.SetAttribute("Seed", StringValue("5"));
+    objectHelper.SetPrefix("/Pat3/Dev3");
+    objectHelper.Install(consumer1);
+    objectHelper.Install(consumer2);
+    objectHelper.Install(consumer3);
+  }
+
+
+  if (multiDevice) {
+    // one producer per patient node answers for all of the patient's devices
+    Ptr<Node> patient1 = Names::Find<Node>("Pat1");
+    Ptr<Node> patient2 = Names::Find<Node>("Pat2");
+    Ptr<Node> patient3 = Names::Find<Node>("Pat3");
+
+    ndn::AppHelper producerHelper("ns3::ndn::HealthProducerExt");
+    producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
+    producerHelper.SetAttribute("ObjectSize", UintegerValue(objectSize));
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat1", patient1);
+    producerHelper.SetPrefix("/Pat1");
+    producerHelper.SetAttribute("Devices", StringValue("Dev1:2:1 Dev2:2:3 Dev3:4:2"));
+    producerHelper.Install(patient1);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat2", patient2);
+    producerHelper.SetPrefix("/Pat2");
+    producerHelper.SetAttribute("Devices", StringValue("Dev1:2:1 Dev2:2:5 Dev3:4:2"));
+    producerHelper.Install(patient2);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat3", patient3);
+    producerHelper.SetPrefix("/Pat3");
+    producerHelper.SetAttribute("Devices", StringValue("Dev1:2:4 Dev2:2:5 Dev3:4:3"));
+    producerHelper.Install(patient3);
+  }
+  else {
+    ndn::AppHelper producerHelper(producerApp);
+    producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
+    if (objectSize > 0) {
+      producerHelper.SetAttribute("ObjectSize", UintegerValue(objectSize));
+    }
+
+    // Register /dst1 prefix with global routing controller and
+    // install producer that will satisfy Interests in /dst1 namespace
+    ndnGlobalRoutingHelper.AddOrigins("Pat1/Dev1", producer1);
+    producerHelper.SetPrefix("Pat1/Dev1");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("1"));
+    producerHelper.Install(producer1);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat1/Dev2", producer2);
+    producerHelper.SetPrefix("/Pat1/Dev2");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("3"));
+    producerHelper.Install(producer2);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat1/Dev3", producer3);
+    producerHelper.SetPrefix("/Pat1/Dev3");
+    producerHelper.SetAttribute("DataType", StringValue("4"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("2"));
+    producerHelper.Install(producer3);
+
+    ndnGlobalRoutingHelper.AddOrigins("Pat2/Dev1", producer4);
+    producerHelper.SetPrefix("Pat2/Dev1");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("1"));
+    producerHelper.Install(producer4);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat2/Dev2", producer5);
+    producerHelper.SetPrefix("/Pat2/Dev2");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("5"));
+    producerHelper.Install(producer5);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat2/Dev3", producer6);
+    producerHelper.SetPrefix("/Pat2/Dev3");
+    producerHelper.SetAttribute("DataType", StringValue("4"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("2"));
+    producerHelper.Install(producer6);
+
+    ndnGlobalRoutingHelper.AddOrigins("Pat3/Dev1", producer7);
+    producerHelper.SetPrefix("Pat3/Dev1");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("4"));
+    producerHelper.Install(producer7);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat3/Dev2", producer8);
+    producerHelper.SetPrefix("/Pat3/Dev2");
+    producerHelper.SetAttribute("DataType", StringValue("2"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("5"));
+    producerHelper.Install(producer8);
+
+    ndnGlobalRoutingHelper.AddOrigins("/Pat3/Dev3", producer9);
+    producerHelper.SetPrefix("/Pat3/Dev3");
+    producerHelper.SetAttribute("DataType", StringValue("4"));
+    producerHelper.SetAttribute("DiseaseRank", StringValue("3"));
+    producerHelper.Install(producer9);
+  }
 
 
   // Calculate and install FIBs
   ndn::GlobalRoutingHelper::CalculateRoutes();
 
-  Simulator::Stop(Seconds(50.0));
+  if (!options.InstallInstrumentation(Seconds(50.0))) {
+    Simulator::Destroy();
+    return 0;
+  }
+
+  if (objectSize > 0) {
+    // object transfer times are kept out of the per-packet delay traces
+    ndn::ObjectDelayTracer::InstallAll("object-delays.txt");
+  }
 
-  ndn::AppDelayTracer::InstallAll("app-delays.txt");
-  Simulator::Run();
+  options.Run();
   Simulator::Destroy();
 
   return 0;
@@ -23,6 +23,10 @@
 #include "ns3/network-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "consumer-health-multi.hpp"
+#include "health-producer-ext.hpp"
+#include "health-scenario-options.hpp"
+
 namespace ns3 {
 
 /**
@@ -50,9 +54,23 @@ namespace ns3 {
 int
 main(int argc, char* argv[])
 {
+  std::string producerApp = "ns3::ndn::HealthProducer";
+  bool multiConsumer = false;
+  bool acuityScaling = false;
+
+  ndn::ScenarioOptions options;
   CommandLine cmd;
+  cmd.AddValue("producerApp", "Producer application type (e.g. ns3::ndn::HealthProducerExt)", producerApp);
+  cmd.AddValue("multiConsumer", "Serve each doctor's patient list from one consumer", multiConsumer);
+  cmd.AddValue("acuityScaling", "With multiConsumer, poll sicker patients more often at the same total rate",
+               acuityScaling);
+  options.AddOptions(cmd);
   cmd.Parse(argc, argv);
 
+  if (acuityScaling && !multiConsumer) {
+    NS_FATAL_ERROR("--acuityScaling needs --multiConsumer");
+  }
+
   AnnotatedTopologyReader topologyReader("", 25);
   topologyReader.SetFileName("src/ndnSIM/examples/topologies/C3P3.txt");
   topologyReader.Read();
@@ -95,74 +113,103 @@ main(int argc, char* argv[])
   Ptr<Node> producer17 = Names::Find<Node>("Dev2Pat6");
   Ptr<Node> producer18 = Names::Find<Node>("Dev3Pat6");
 
-  ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealth");
-  consumerHelper.SetAttribute("Frequency", StringValue("5")); // 5 interests a second
-  consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
-
-  // on the first consumer node install a Consumer application
-  // that will express interests in /dst1 namespace
-  consumerHelper.SetAttribute("Seed", StringValue("3"));
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat1");
-  consumerHelper.Install(consumer3);
-  
-  consumerHelper.SetAttribute("Seed", StringValue("7"));
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat2");
-  consumerHelper.Install(consumer3);
-
-  consumerHelper.SetAttribute("Seed", StringValue("5"));
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat3");
-  consumerHelper.Install(consumer3);
-
-  consumerHelper.SetAttribute("Seed", StringValue("3"));
-  consumerHelper.SetPrefix("/Pat4");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat4");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat4");
-  consumerHelper.Install(consumer3);
-  
-  consumerHelper.SetAttribute("Seed", StringValue("7"));
-  consumerHelper.SetPrefix("/Pat5");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat5");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat5");
-  consumerHelper.Install(consumer3);
-
-  consumerHelper.SetAttribute("Seed", StringValue("5"));
-  consumerHelper.SetPrefix("/Pat6");
-  consumerHelper.Install(consumer1);
-
-  consumerHelper.SetPrefix("/Pat6");
-  consumerHelper.Install(consumer2);
-
-  consumerHelper.SetPrefix("/Pat6");
-  consumerHelper.Install(consumer3);
-
-
-  ndn::AppHelper producerHelper("ns3::ndn::HealthProducer");
+  if (multiConsumer) {
+    // one consumer application per doctor polls the whole patient list
+    ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealthMulti");
+    consumerHelper.SetAttribute("Prefixes", StringValue("/Pat1/Dev1 /Pat1/Dev2 /Pat1/Dev3 "
+                                                        "/Pat2/Dev1 /Pat2/Dev2 /Pat2/Dev3 "
+                                                        "/Pat3/Dev1 /Pat3/Dev2 /Pat3/Dev3 "
+                                                        "/Pat4/Dev1 /Pat4/Dev2 /Pat4/Dev3 "
+                                                        "/Pat5/Dev1 /Pat5/Dev2 /Pat5/Dev3 "
+                                                        "/Pat6/Dev1 /Pat6/Dev2 /Pat6/Dev3"));
+    // 5 interests a second per patient, spread over its 3 devices, as in the
+    // one-consumer-per-patient setup below
+    consumerHelper.SetAttribute("Frequency", DoubleValue(5.0 / 3));
+    consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
+    consumerHelper.SetAttribute("Seed", StringValue("3"));
+    consumerHelper.SetAttribute("RankScaling", StringValue(acuityScaling ? "true" : "false"));
+    // the DiseaseRank of each producer below: ranks are only learned from
+    // HealthProducerExt content, and the default HealthProducer has none
+    consumerHelper.SetAttribute("Ranks", StringValue("/Pat1/Dev1:1 /Pat1/Dev2:3 /Pat1/Dev3:2 "
+                                                     "/Pat2/Dev1:1 /Pat2/Dev2:5 /Pat2/Dev3:2 "
+                                                     "/Pat3/Dev1:4 /Pat3/Dev2:5 /Pat3/Dev3:3 "
+                                                     "/Pat4/Dev1:1 /Pat4/Dev2:3 /Pat4/Dev3:2 "
+                                                     "/Pat5/Dev1:1 /Pat5/Dev2:5 /Pat5/Dev3:2 "
+                                                     "/Pat6/Dev1:4 /Pat6/Dev2:5 /Pat6/Dev3:3"));
+    consumerHelper.Install(consumer1);
+    consumerHelper.Install(consumer2);
+    consumerHelper.Install(consumer3);
+  }
+  else {
+    ndn::AppHelper consumerHelper("ns3::ndn::ConsumerHealth");
+    consumerHelper.SetAttribute("Frequency", StringValue("5")); // 5 interests a second
+    consumerHelper.SetAttribute("Randomize", StringValue("exponential"));
+
+    // on the first consumer node install a Consumer application
+    // that will express interests in /dst1 namespace
+    consumerHelper.SetAttribute("Seed", StringValue("3"));
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat1");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("7"));
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat2");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("5"));
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat3");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("3"));
+    consumerHelper.SetPrefix("/Pat4");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat4");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat4");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("7"));
+    consumerHelper.SetPrefix("/Pat5");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat5");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat5");
+    consumerHelper.Install(consumer3);
+
+    consumerHelper.SetAttribute("Seed", StringValue("5"));
+    consumerHelper.SetPrefix("/Pat6");
+    consumerHelper.Install(consumer1);
+
+    consumerHelper.SetPrefix("/Pat6");
+    consumerHelper.Install(consumer2);
+
+    consumerHelper.SetPrefix("/Pat6");
+    consumerHelper.Install(consumer3);
+  }
+
+
+  ndn::AppHelper producerHelper(producerApp);
   producerHelper.SetAttribute("PayloadSize", StringValue("1018"));
 
   // Register /dst1 prefix with global routing controller and
@@ -227,7 +274,7 @@ main(int argc, char* argv[])
   producerHelper.SetAttribute("DiseaseRank", StringValue("1"));
   producerHelper.Install(producer10);
 
-  ndnGlobalRoutingHelper.AddOrigins("/Pat1/Dev2", produce11);
+  ndnGlobalRoutingHelper.AddOrigins("/Pat4/Dev2", producer11);
   producerHelper.SetPrefix("/Pat4/Dev2");
   producerHelper.SetAttribute("DataType", StringValue("2"));
   producerHelper.SetAttribute("DiseaseRank", StringValue("3"));
@@ -278,10 +325,12 @@ main(int argc, char* argv[])
   // Calculate and install FIBs
   ndn::GlobalRoutingHelper::CalculateRoutes();
 
-  Simulator::Stop(Seconds(50.0));
+  if (!options.InstallInstrumentation(Seconds(50.0))) {
+    Simulator::Destroy();
+    return 0;
+  }
 
-  ndn::AppDelayTracer::InstallAll("app-delays.txt");
-  Simulator::Run();
+  options.Run();
   Simulator::Destroy();
 
   return 0;
@@ -0,0 +1,598 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// consumer-health-multi.hpp
+
+#ifndef CONSUMER_HEALTH_MULTI_HPP
+#define CONSUMER_HEALTH_MULTI_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.hpp"
+#include "ns3/ndnSIM/utils/ndn-ns3-packet-tag.hpp"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include "ns3/uinteger.h"
+
+#include "health-exponential-batch.hpp"
+#include "health-object-pool.hpp"
+#include "health-timer-wheel.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * \brief ConsumerHealth that polls a doctor's whole patient list from one application
+ *
+ * `Prefixes` is a space-separated list of `prefix[:frequency]` entries, e.g.
+ * `"/Pat1/Dev1 /Pat1/Dev2:10 /Pat2/Dev1"`; entries without a frequency use
+ * `Frequency`.  Each prefix names one device, `/<patient>/<device>`, and its
+ * interests are `/<patient>/<device>/<seq>`, the naming scheme HealthProducerExt
+ * answers.  Every prefix keeps its own sequence numbers and inter-arrival stream
+ * (derived from `Seed` and the prefix position), but all prefixes share one face,
+ * one send event and one retransmission check, so a doctor polling N devices
+ * costs one application instead of N.
+ *
+ * Retransmission deadlines live in a TimerWheel advanced by one periodic
+ * `RetxTimer` tick rather than in per-interest events: sending an interest files
+ * one wheel entry and an arriving Data just leaves its entry to be discarded as
+ * stale, so timers cost no scheduler inserts or cancels at all.
+ *
+ * With `RankScaling`, the per-prefix rates are redistributed by patient acuity
+ * within a fixed budget of `RateBudget` interests per second (0: the sum of the
+ * configured per-prefix frequencies, so total load stays the same).  A prefix's
+ * rank comes from the `Ranks` table (`"/Pat1/Dev1:1 /Pat2/Dev1:5"`) or, for prefixes
+ * not in the table, is learned as the highest DiseaseRank byte seen in returned Data
+ * content (the HealthProducerExt content header; Data without a rank there is a
+ * fatal error, as the rates would be split on garbage).  Each prefix gets a share
+ * of the budget proportional to the weight of its rank from `RankWeights`
+ * (`"rank:weight ..."`, ranks without an entry weigh as much as their number);
+ * prefixes whose rank is not known yet weigh 1.
+ *
+ * Delays are reported through the same `FirstInterestDataDelay` and
+ * `LastRetransmittedInterestDataDelay` trace sources as ndn::Consumer, so
+ * AppDelayTracer works unchanged; `PrefixDelay` additionally reports the prefix.
+ */
+class ConsumerHealthMulti : public App {
+public:
+  typedef void (*LastRetransmittedInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay,
+                                                              int32_t hopCount);
+  typedef void (*FirstInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay,
+                                                 uint32_t retxCount, int32_t hopCount);
+  typedef void (*PrefixDelayCallback)(Ptr<App> app, const Name& prefix, uint32_t seqno, Time delay,
+                                      uint32_t retxCount, int32_t hopCount);
+  typedef void (*TimedOutInterestsCallback)(Ptr<App> app, uint32_t seqno);
+
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::ndn::ConsumerHealthMulti")
+        .SetGroupName("Ndn")
+        .SetParent<App>()
+        .AddConstructor<ConsumerHealthMulti>()
+        .AddAttribute("Prefixes", "Space-separated list of prefix[:frequency] entries", StringValue(""),
+                      MakeStringAccessor(&ConsumerHealthMulti::m_prefixList), MakeStringChecker())
+        .AddAttribute("Frequency", "Default frequency of interest packets per prefix",
+                      StringValue("1.0"), MakeDoubleAccessor(&ConsumerHealthMulti::m_frequency),
+                      MakeDoubleChecker<double>())
+        .AddAttribute("Randomize",
+                      "Type of send time randomization: none (default), uniform, exponential",
+                      StringValue("none"), MakeStringAccessor(&ConsumerHealthMulti::m_randomType),
+                      MakeStringChecker())
+        .AddAttribute("Seed", "Seed of the inter-arrival streams", UintegerValue(1),
+                      MakeUintegerAccessor(&ConsumerHealthMulti::SetSeed, &ConsumerHealthMulti::GetSeed),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("RankScaling", "Distribute RateBudget across prefixes by patient acuity",
+                      BooleanValue(false), MakeBooleanAccessor(&ConsumerHealthMulti::m_rankScaling),
+                      MakeBooleanChecker())
+        .AddAttribute("RateBudget", "Total interests per second across prefixes (0: sum of frequencies)",
+                      DoubleValue(0.0), MakeDoubleAccessor(&ConsumerHealthMulti::m_rateBudget),
+                      MakeDoubleChecker<double>(0.0))
+        .AddAttribute("Ranks", "Space-separated prefix:rank entries, overriding learned ranks",
+                      StringValue(""), MakeStringAccessor(&ConsumerHealthMulti::m_rankList),
+                      MakeStringChecker())
+        .AddAttribute("RankWeights", "Space-separated rank:weight entries (default weight = rank)",
+                      StringValue(""), MakeStringAccessor(&ConsumerHealthMulti::m_rankWeightList),
+                      MakeStringChecker())
+        .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
+                      MakeTimeAccessor(&ConsumerHealthMulti::m_interestLifeTime), MakeTimeChecker())
+        .AddAttribute("RetxTimer",
+                      "Timeout defining how frequent retransmission timeouts should be checked",
+                      StringValue("50ms"), MakeTimeAccessor(&ConsumerHealthMulti::m_retxTimer),
+                      MakeTimeChecker())
+
+        .AddTraceSource("LastRetransmittedInterestDataDelay",
+                        "Delay between last retransmitted Interest and received Data",
+                        MakeTraceSourceAccessor(&ConsumerHealthMulti::m_lastRetransmittedInterestDataDelay),
+                        "ns3::ndn::ConsumerHealthMulti::LastRetransmittedInterestDataDelayCallback")
+        .AddTraceSource("FirstInterestDataDelay",
+                        "Delay between first transmitted Interest and received Data",
+                        MakeTraceSourceAccessor(&ConsumerHealthMulti::m_firstInterestDataDelay),
+                        "ns3::ndn::ConsumerHealthMulti::FirstInterestDataDelayCallback")
+        .AddTraceSource("PrefixDelay",
+                        "Delay between first transmitted Interest and received Data, with the prefix",
+                        MakeTraceSourceAccessor(&ConsumerHealthMulti::m_prefixDelay),
+                        "ns3::ndn::ConsumerHealthMulti::PrefixDelayCallback")
+        .AddTraceSource("TimedOutInterests", "Interest whose retransmission timer expired",
+                        MakeTraceSourceAccessor(&ConsumerHealthMulti::m_timedOutInterests),
+                        "ns3::ndn::ConsumerHealthMulti::TimedOutInterestsCallback");
+
+    return tid;
+  }
+
+  ConsumerHealthMulti()
+    : m_frequency(1.0)
+    , m_seed(1)
+    , m_rankScaling(false)
+    , m_rateBudget(0.0)
+    , m_rand(CreateObject<UniformRandomVariable>())
+    , m_srtt(Seconds(0))
+    , m_rttVar(Seconds(0))
+    , m_rto(Seconds(1))
+  {
+  }
+
+  virtual void
+  OnData(shared_ptr<const Data> data)
+  {
+    if (!m_active)
+      return;
+
+    App::OnData(data); // tracing inside
+
+    const Name& name = data->getName();
+    if (name.empty() || !name.at(-1).isSequenceNumber()) {
+      return;
+    }
+
+    uint32_t seq = static_cast<uint32_t>(name.at(-1).toSequenceNumber());
+    size_t index = FindPrefix(name.getPrefix(-1));
+    if (index == m_prefixes.size()) {
+      return;
+    }
+
+    auto pending = m_pending.find(PendingKey(index, seq));
+    if (pending == m_pending.end()) {
+      return;
+    }
+
+    int hopCount = 0;
+    auto ns3PacketTag = data->getTag<Ns3PacketTag>();
+    if (ns3PacketTag != nullptr) {
+      FwHopCountTag hopCountTag;
+      if (ns3PacketTag->getPacket()->PeekPacketTag(hopCountTag)) {
+        hopCount = hopCountTag.Get();
+      }
+    }
+
+    const PendingInterest& interest = pending->second;
+    Time lastDelay = Simulator::Now() - interest.lastSent;
+    Time fullDelay = Simulator::Now() - interest.firstSent;
+
+    m_lastRetransmittedInterestDataDelay(this, seq, lastDelay, hopCount);
+    m_firstInterestDataDelay(this, seq, fullDelay, interest.retxCount, hopCount);
+    m_prefixDelay(this, m_prefixes[index].prefix, seq, fullDelay, interest.retxCount, hopCount);
+
+    if (interest.retxCount == 1) {
+      // Karn's algorithm: only unambiguous samples update the estimator
+      UpdateRto(lastDelay);
+    }
+
+    m_pending.erase(pending);
+
+    // a late Data can still beat the queued retransmission
+    std::vector<uint32_t>& retxSeqs = m_prefixes[index].retxSeqs;
+    retxSeqs.erase(std::remove(retxSeqs.begin(), retxSeqs.end(), seq), retxSeqs.end());
+
+    if (m_rankScaling && !m_prefixes[index].fixedRank) {
+      LearnRank(index, data->getContent());
+    }
+  }
+
+protected:
+  struct PrefixState {
+    Name prefix;
+    double frequency;
+    double baseFrequency;
+    uint32_t rank; ///< 0 while unknown
+    bool fixedRank;
+    uint32_t seq;
+    Time nextSend;
+    std::vector<uint32_t> retxSeqs;
+    ExponentialBatch interArrival;
+  };
+
+  struct PendingInterest {
+    Time firstSent;
+    Time lastSent;
+    uint32_t retxCount;
+    uint32_t generation; ///< bumped on every (re)transmission, matches the live wheel entry
+  };
+
+  typedef std::pair<size_t, uint32_t> PendingKey;
+
+  struct RetxDeadline {
+    PendingKey key;
+    uint32_t generation;
+  };
+
+  virtual void
+  StartApplication()
+  {
+    App::StartApplication();
+
+    m_prefixes.clear();
+    m_pending.clear();
+    m_retxWheel = TimerWheel<RetxDeadline>();
+    m_retxWheelStart = Simulator::Now();
+
+    std::istringstream entries(m_prefixList);
+    std::string entry;
+    while (entries >> entry) {
+      PrefixState state;
+      size_t colon = entry.find(':');
+      state.prefix = Name(entry.substr(0, colon));
+      state.frequency = colon == std::string::npos ? m_frequency : std::stod(entry.substr(colon + 1));
+      if (state.frequency <= 0) {
+        NS_FATAL_ERROR("Prefix " << state.prefix << " needs a positive frequency");
+      }
+      state.baseFrequency = state.frequency;
+      state.rank = 0;
+      state.fixedRank = false;
+      state.seq = 0;
+      state.interArrival.Reseed((static_cast<uint64_t>(m_seed) << 16) + m_prefixes.size());
+      m_prefixes.push_back(state);
+    }
+
+    ParseRanks();
+    if (m_rankScaling) {
+      Reallocate();
+    }
+
+    for (PrefixState& state : m_prefixes) {
+      state.nextSend = Simulator::Now() + NextInterval(state);
+    }
+
+    ScheduleNextPacket();
+    m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerHealthMulti::CheckRetxTimeout, this);
+  }
+
+  virtual void
+  StopApplication()
+  {
+    Simulator::Cancel(m_sendEvent);
+    Simulator::Cancel(m_retxEvent);
+    App::StopApplication();
+  }
+
+  /**
+   * \brief Set the seed; a running application continues with the reseeded streams
+   */
+  void
+  SetSeed(uint32_t seed)
+  {
+    m_seed = seed;
+    for (size_t index = 0; index < m_prefixes.size(); ++index) {
+      m_prefixes[index].interArrival.Reseed((static_cast<uint64_t>(m_seed) << 16) + index);
+    }
+  }
+
+  uint32_t
+  GetSeed() const
+  {
+    return m_seed;
+  }
+
+  void
+  ParseRanks()
+  {
+    m_rankWeights.clear();
+    std::istringstream weights(m_rankWeightList);
+    std::string entry;
+    while (weights >> entry) {
+      size_t colon = entry.find(':');
+      if (colon == std::string::npos) {
+        NS_FATAL_ERROR("Rank weight entry " << entry << " is not rank:weight");
+      }
+      uint32_t rank = std::stoul(entry.substr(0, colon));
+      double weight = std::stod(entry.substr(colon + 1));
+      if (rank == 0 || weight <= 0) {
+        NS_FATAL_ERROR("Rank weight entry " << entry << " needs a rank and a weight above 0");
+      }
+      m_rankWeights[rank] = weight;
+    }
+
+    std::istringstream ranks(m_rankList);
+    while (ranks >> entry) {
+      size_t colon = entry.find(':');
+      if (colon == std::string::npos) {
+        NS_FATAL_ERROR("Rank entry " << entry << " is not prefix:rank");
+      }
+      size_t index = FindPrefix(Name(entry.substr(0, colon)));
+      if (index == m_prefixes.size()) {
+        NS_FATAL_ERROR("Rank entry " << entry << " names a prefix that is not polled");
+      }
+      m_prefixes[index].rank = std::stoul(entry.substr(colon + 1));
+      if (m_prefixes[index].rank == 0) {
+        NS_FATAL_ERROR("Rank entry " << entry << " needs a rank above 0");
+      }
+      m_prefixes[index].fixedRank = true;
+    }
+  }
+
+  /**
+   * \brief Raise the rank of prefix @p index to the DiseaseRank carried in @p content
+   */
+  void
+  LearnRank(size_t index, const Block& content)
+  {
+    uint32_t rank = content.value_size() < 2 ? 0 : content.value()[1];
+    if (rank == 0) {
+      NS_FATAL_ERROR("Data for " << m_prefixes[index].prefix << " carries no DiseaseRank byte; "
+                     "list the prefix in Ranks unless HealthProducerExt answers it");
+    }
+
+    if (rank > m_prefixes[index].rank) {
+      m_prefixes[index].rank = rank;
+      Reallocate();
+    }
+  }
+
+  double
+  GetRankWeight(uint32_t rank) const
+  {
+    if (rank == 0) {
+      return 1.0;
+    }
+
+    auto weight = m_rankWeights.find(rank);
+    return weight != m_rankWeights.end() ? weight->second : static_cast<double>(rank);
+  }
+
+  /**
+   * \brief Split the rate budget across prefixes in proportion to their rank weights
+   *
+   * New rates apply from each prefix's next inter-arrival draw.
+   */
+  void
+  Reallocate()
+  {
+    double budget = m_rateBudget;
+    if (budget <= 0) {
+      for (const PrefixState& state : m_prefixes) {
+        budget += state.baseFrequency;
+      }
+    }
+
+    double totalWeight = 0;
+    for (const PrefixState& state : m_prefixes) {
+      totalWeight += GetRankWeight(state.rank);
+    }
+    if (totalWeight <= 0) {
+      return;
+    }
+
+    for (PrefixState& state : m_prefixes) {
+      state.frequency = budget * GetRankWeight(state.rank) / totalWeight;
+    }
+  }
+
+  /**
+   * \brief Send every interest that is due and arm the single send event for the next one
+   */
+  void
+  SendDue()
+  {
+    if (!m_active)
+      return;
+
+    Time now = Simulator::Now();
+    for (size_t index = 0; index < m_prefixes.size(); ++index) {
+      PrefixState& state = m_prefixes[index];
+      while (state.nextSend <= now) {
+        SendInterest(index);
+        state.nextSend += NextInterval(state);
+      }
+    }
+
+    ScheduleNextPacket();
+  }
+
+  void
+  ScheduleNextPacket()
+  {
+    if (m_prefixes.empty()) {
+      return;
+    }
+
+    Time next = m_prefixes.front().nextSend;
+    for (const PrefixState& state : m_prefixes) {
+      next = std::min(next, state.nextSend);
+    }
+
+    Simulator::Cancel(m_sendEvent);
+    m_sendEvent = Simulator::Schedule(next - Simulator::Now(), &ConsumerHealthMulti::SendDue, this);
+  }
+
+  Time
+  NextInterval(PrefixState& state)
+  {
+    double mean = 1.0 / state.frequency;
+    if (m_randomType == "exponential") {
+      return Seconds(state.interArrival.GetValue(mean));
+    }
+    else if (m_randomType == "uniform") {
+      return Seconds(m_rand->GetValue(0.0, 2 * mean));
+    }
+    return Seconds(mean);
+  }
+
+  void
+  SendInterest(size_t index)
+  {
+    PrefixState& state = m_prefixes[index];
+
+    uint32_t seq;
+    if (!state.retxSeqs.empty()) {
+      seq = state.retxSeqs.back();
+      state.retxSeqs.pop_back();
+    }
+    else {
+      seq = state.seq++;
+    }
+
+    Name nameWithSequence(state.prefix);
+    nameWithSequence.appendSequenceNumber(seq);
+
+    shared_ptr<Interest> interest = MakePooled<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(nameWithSequence);
+    interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+    Time now = Simulator::Now();
+    PendingInterest& pending = m_pending[PendingKey(index, seq)];
+    if (pending.retxCount == 0) {
+      pending.firstSent = now;
+    }
+    pending.lastSent = now;
+    pending.retxCount++;
+    pending.generation++;
+
+    RetxDeadline deadline = {PendingKey(index, seq), pending.generation};
+    m_retxWheel.Insert(ToTicks(now + m_rto, true), deadline);
+
+    m_transmittedInterests(interest, this, m_face);
+    m_face->onReceiveInterest(*interest);
+  }
+
+  void
+  CheckRetxTimeout()
+  {
+    bool timedOut = false;
+
+    auto expired = [this, &timedOut](const RetxDeadline& deadline) {
+      auto pending = m_pending.find(deadline.key);
+      if (pending == m_pending.end() || pending->second.generation != deadline.generation) {
+        // Data arrived or the interest was sent again since this deadline was filed
+        return;
+      }
+
+      // retransmitted at the prefix's next send slot, ahead of new sequence numbers
+      m_prefixes[deadline.key.first].retxSeqs.push_back(deadline.key.second);
+      m_timedOutInterests(this, deadline.key.second);
+      timedOut = true;
+    };
+    m_retxWheel.Advance(ToTicks(Simulator::Now(), false), expired);
+
+    if (timedOut) {
+      m_rto = std::min(m_rto * 2, Seconds(60));
+    }
+
+    m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerHealthMulti::CheckRetxTimeout, this);
+  }
+
+  /**
+   * \brief Wheel tick of @p time, rounded up for deadlines and down for the current time
+   */
+  uint64_t
+  ToTicks(Time time, bool roundUp) const
+  {
+    int64_t elapsed = (time - m_retxWheelStart).GetTimeStep();
+    int64_t tick = m_retxTimer.GetTimeStep();
+    return static_cast<uint64_t>(roundUp ? (elapsed + tick - 1) / tick : elapsed / tick);
+  }
+
+  void
+  UpdateRto(Time rtt)
+  {
+    if (m_srtt.IsZero()) {
+      m_srtt = rtt;
+      m_rttVar = rtt / 2;
+    }
+    else {
+      Time error = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+      m_rttVar = (m_rttVar * 3 + error) / 4;
+      m_srtt = (m_srtt * 7 + rtt) / 8;
+    }
+    m_rto = std::max(m_srtt + m_rttVar * 4, MilliSeconds(200));
+  }
+
+  size_t
+  FindPrefix(const Name& prefix) const
+  {
+    for (size_t index = 0; index < m_prefixes.size(); ++index) {
+      if (m_prefixes[index].prefix == prefix) {
+        return index;
+      }
+    }
+    return m_prefixes.size();
+  }
+
+protected:
+  std::string m_prefixList;
+  double m_frequency;
+  std::string m_randomType;
+  bool m_rankScaling;
+  double m_rateBudget;
+  std::string m_rankList;
+  std::string m_rankWeightList;
+  std::map<uint32_t, double> m_rankWeights;
+  uint32_t m_seed;
+  Time m_interestLifeTime;
+  Time m_retxTimer;
+
+  Ptr<UniformRandomVariable> m_rand;
+  std::vector<PrefixState> m_prefixes;
+  std::map<PendingKey, PendingInterest> m_pending;
+
+  EventId m_sendEvent;
+  EventId m_retxEvent;
+  TimerWheel<RetxDeadline> m_retxWheel;
+  Time m_retxWheelStart;
+
+  Time m_srtt;
+  Time m_rttVar;
+  Time m_rto;
+
+  TracedCallback<Ptr<App>, uint32_t, Time, int32_t> m_lastRetransmittedInterestDataDelay;
+  TracedCallback<Ptr<App>, uint32_t, Time, uint32_t, int32_t> m_firstInterestDataDelay;
+  TracedCallback<Ptr<App>, const Name&, uint32_t, Time, uint32_t, int32_t> m_prefixDelay;
+  TracedCallback<Ptr<App>, uint32_t> m_timedOutInterests;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerHealthMulti);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // CONSUMER_HEALTH_MULTI_HPP
@@ -0,0 +1,495 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// consumer-health-object.hpp
+
+#ifndef CONSUMER_HEALTH_OBJECT_HPP
+#define CONSUMER_HEALTH_OBJECT_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include "ns3/uinteger.h"
+
+#include "health-exponential-batch.hpp"
+#include "health-object-pool.hpp"
+#include "health-producer-ext.hpp"
+#include "health-timer-wheel.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * \brief Consumer that fetches segmented objects published by HealthProducerExt
+ *
+ * Every `1 / Frequency` seconds (or exponentially distributed with `Randomize`)
+ * a new object `/<Prefix>/<seq>` is requested.  Its manifest gives the number of
+ * segments, which are then fetched as `/<Prefix>/<seq>/<segment>` with up to
+ * `Pipeline` segment interests in flight, shared by all objects being fetched;
+ * older objects get their segments first.  A timed-out interest keeps its pipeline
+ * slot and is sent again right away, with the same adaptive timeout and
+ * TimerWheel as ConsumerHealthMulti.  An object is given up (`DroppedObject`, and a
+ * line on std::clog) once one of its interests has been retransmitted `MaxRetx`
+ * times, or when its manifest is too short to be one.
+ *
+ * A transfer is measured per object, from the first manifest interest to the last
+ * segment, and reported only through `ObjectDelay`, with the object's sequence
+ * number, the object and segment sizes and a retransmission count of one plus
+ * the number of retransmitted interests of the object.  Per-packet delay traces
+ * (`FirstInterestDataDelay`, AppDelayTracer, RunController, LiveMetrics) are not
+ * fed, so object times never mix with reading delays; ObjectDelayTracer writes
+ * them to a file of their own.
+ */
+class ConsumerHealthObject : public App {
+public:
+  typedef void (*ObjectDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, uint64_t objectSize,
+                                      uint32_t segmentCount, uint32_t retxCount);
+  typedef void (*DroppedObjectCallback)(Ptr<App> app, uint32_t seqno, uint32_t retxCount);
+  typedef void (*TimedOutInterestsCallback)(Ptr<App> app, uint32_t seqno);
+
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::ndn::ConsumerHealthObject")
+        .SetGroupName("Ndn")
+        .SetParent<App>()
+        .AddConstructor<ConsumerHealthObject>()
+        .AddAttribute("Prefix", "Name of the Interest", StringValue("/"),
+                      MakeNameAccessor(&ConsumerHealthObject::m_interestName), MakeNameChecker())
+        .AddAttribute("Frequency", "Frequency of object requests", StringValue("1.0"),
+                      MakeDoubleAccessor(&ConsumerHealthObject::m_frequency),
+                      MakeDoubleChecker<double>())
+        .AddAttribute("Randomize", "Type of send time randomization: none (default), exponential",
+                      StringValue("none"), MakeStringAccessor(&ConsumerHealthObject::m_randomType),
+                      MakeStringChecker())
+        .AddAttribute("Seed", "Seed of the inter-arrival stream", UintegerValue(1),
+                      MakeUintegerAccessor(&ConsumerHealthObject::SetSeed, &ConsumerHealthObject::GetSeed),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("Pipeline", "Maximum number of segment interests in flight", UintegerValue(8),
+                      MakeUintegerAccessor(&ConsumerHealthObject::m_pipeline),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("MaxRetx", "Retransmissions of one interest before its object is given up",
+                      UintegerValue(8), MakeUintegerAccessor(&ConsumerHealthObject::m_maxRetx),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
+                      MakeTimeAccessor(&ConsumerHealthObject::m_interestLifeTime), MakeTimeChecker())
+        .AddAttribute("RetxTimer",
+                      "Timeout defining how frequent retransmission timeouts should be checked",
+                      StringValue("50ms"), MakeTimeAccessor(&ConsumerHealthObject::m_retxTimer),
+                      MakeTimeChecker())
+
+        .AddTraceSource("ObjectDelay", "Object transfer time with the object and segment sizes",
+                        MakeTraceSourceAccessor(&ConsumerHealthObject::m_objectDelay),
+                        "ns3::ndn::ConsumerHealthObject::ObjectDelayCallback")
+        .AddTraceSource("DroppedObject", "Object given up, with the number of interests retransmitted for it",
+                        MakeTraceSourceAccessor(&ConsumerHealthObject::m_droppedObject),
+                        "ns3::ndn::ConsumerHealthObject::DroppedObjectCallback")
+        .AddTraceSource("TimedOutInterests",
+                        "Interest whose retransmission timer expired, reported with the object sequence number",
+                        MakeTraceSourceAccessor(&ConsumerHealthObject::m_timedOutInterests),
+                        "ns3::ndn::ConsumerHealthObject::TimedOutInterestsCallback");
+
+    return tid;
+  }
+
+  ConsumerHealthObject()
+    : m_frequency(1.0)
+    , m_seed(1)
+    , m_pipeline(8)
+    , m_maxRetx(8)
+    , m_rand(CreateObject<UniformRandomVariable>())
+    , m_seq(0)
+    , m_inFlight(0)
+    , m_srtt(Seconds(0))
+    , m_rttVar(Seconds(0))
+    , m_rto(Seconds(1))
+  {
+  }
+
+  virtual void
+  OnData(shared_ptr<const Data> data)
+  {
+    if (!m_active)
+      return;
+
+    App::OnData(data); // tracing inside
+
+    PartKey key;
+    if (!ParseName(data->getName(), key)) {
+      return;
+    }
+
+    auto pending = m_pending.find(key);
+    if (pending == m_pending.end()) {
+      return;
+    }
+
+    if (pending->second.retxCount == 1) {
+      // Karn's algorithm: only unambiguous samples update the estimator
+      UpdateRto(Simulator::Now() - pending->second.lastSent);
+    }
+    m_pending.erase(pending);
+    --m_inFlight;
+
+    auto object = m_objects.find(key.first);
+    if (object != m_objects.end()) {
+      if (key.second == MANIFEST) {
+        if (!ReadManifest(object->second, data->getContent())) {
+          Drop(object, "no object manifest");
+          FillPipeline();
+          return;
+        }
+      }
+      else {
+        ++object->second.received;
+      }
+
+      if (object->second.haveManifest && object->second.received == object->second.segmentCount) {
+        Complete(object);
+      }
+    }
+
+    FillPipeline();
+  }
+
+protected:
+  enum : uint32_t { MANIFEST = 0xFFFFFFFF }; ///< segment number standing for the manifest
+
+  /// (object sequence number, segment number or MANIFEST)
+  typedef std::pair<uint32_t, uint32_t> PartKey;
+
+  struct ObjectState {
+    Time firstSent;
+    uint64_t size;
+    bool haveManifest;
+    uint32_t segmentCount;
+    uint32_t nextSegment;
+    uint32_t received;
+    uint32_t retxCount;
+  };
+
+  struct PendingInterest {
+    Time lastSent;
+    uint32_t retxCount;
+    uint32_t generation; ///< bumped on every (re)transmission, matches the live wheel entry
+  };
+
+  struct RetxDeadline {
+    PartKey key;
+    uint32_t generation;
+  };
+
+  virtual void
+  StartApplication()
+  {
+    App::StartApplication();
+
+    m_objects.clear();
+    m_pending.clear();
+    m_inFlight = 0;
+    m_retxWheel = TimerWheel<RetxDeadline>();
+    m_retxWheelStart = Simulator::Now();
+    m_interArrival.Reseed(m_seed);
+
+    m_sendEvent = Simulator::Schedule(NextInterval(), &ConsumerHealthObject::RequestObject, this);
+    m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerHealthObject::CheckRetxTimeout, this);
+  }
+
+  virtual void
+  StopApplication()
+  {
+    Simulator::Cancel(m_sendEvent);
+    Simulator::Cancel(m_retxEvent);
+    App::StopApplication();
+  }
+
+  /**
+   * \brief Set the seed; a running application continues with the reseeded stream
+   */
+  void
+  SetSeed(uint32_t seed)
+  {
+    m_seed = seed;
+    m_interArrival.Reseed(m_seed);
+  }
+
+  uint32_t
+  GetSeed() const
+  {
+    return m_seed;
+  }
+
+  Time
+  NextInterval()
+  {
+    double mean = 1.0 / m_frequency;
+    if (m_randomType == "exponential") {
+      return Seconds(m_interArrival.GetValue(mean));
+    }
+    return Seconds(mean);
+  }
+
+  /**
+   * \brief Start fetching the next object; manifests bypass the pipeline limit
+   */
+  void
+  RequestObject()
+  {
+    uint32_t seq = m_seq++;
+    ObjectState& object = m_objects[seq];
+    object.firstSent = Simulator::Now();
+    SendInterest(PartKey(seq, MANIFEST));
+
+    m_sendEvent = Simulator::Schedule(NextInterval(), &ConsumerHealthObject::RequestObject, this);
+  }
+
+  /**
+   * \brief false if @p content is too short to be a manifest
+   */
+  bool
+  ReadManifest(ObjectState& object, const Block& content)
+  {
+    if (content.value_size() < HealthProducerExt::MANIFEST_SIZE) {
+      return false;
+    }
+
+    const uint8_t* value = content.value();
+    object.size = ReadBigEndian(value + 16, 8);
+    object.segmentCount = static_cast<uint32_t>(ReadBigEndian(value + 24, 4));
+    object.nextSegment = 0;
+    object.received = 0;
+    object.haveManifest = true;
+    return true;
+  }
+
+  /**
+   * \brief Send the next segments of the oldest objects until `Pipeline` interests are in flight
+   */
+  void
+  FillPipeline()
+  {
+    for (auto object = m_objects.begin(); object != m_objects.end() && m_inFlight < m_pipeline; ++object) {
+      ObjectState& state = object->second;
+      while (state.nextSegment < state.segmentCount && m_inFlight < m_pipeline) {
+        SendInterest(PartKey(object->first, state.nextSegment++));
+      }
+    }
+  }
+
+  void
+  SendInterest(const PartKey& key)
+  {
+    Name name(m_interestName);
+    name.appendSequenceNumber(key.first);
+    if (key.second != MANIFEST) {
+      name.appendSegment(key.second);
+    }
+
+    shared_ptr<Interest> interest = MakePooled<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(name);
+    interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+    Time now = Simulator::Now();
+    PendingInterest& pending = m_pending[key];
+    if (pending.retxCount == 0) {
+      ++m_inFlight;
+    }
+    else {
+      m_objects[key.first].retxCount++;
+    }
+    pending.lastSent = now;
+    pending.retxCount++;
+    pending.generation++;
+
+    RetxDeadline deadline = {key, pending.generation};
+    m_retxWheel.Insert(ToTicks(now + m_rto, true), deadline);
+
+    m_transmittedInterests(interest, this, m_face);
+    m_face->onReceiveInterest(*interest);
+  }
+
+  void
+  Complete(std::map<uint32_t, ObjectState>::iterator object)
+  {
+    const ObjectState& state = object->second;
+    Time delay = Simulator::Now() - state.firstSent;
+
+    m_objectDelay(this, object->first, delay, state.size, state.segmentCount, state.retxCount + 1);
+
+    m_objects.erase(object);
+  }
+
+  /**
+   * \brief Give up on an object: forget its pending interests and free their pipeline slots
+   */
+  void
+  Drop(std::map<uint32_t, ObjectState>::iterator object, const char* reason)
+  {
+    auto first = m_pending.lower_bound(PartKey(object->first, 0));
+    auto last = m_pending.upper_bound(PartKey(object->first, MANIFEST));
+    m_inFlight -= static_cast<uint32_t>(std::distance(first, last));
+    m_pending.erase(first, last);
+
+    std::clog << "ConsumerHealthObject: dropped " << m_interestName << "/" << object->first << " ("
+              << reason << ")" << std::endl;
+    m_droppedObject(this, object->first, object->second.retxCount);
+    m_objects.erase(object);
+  }
+
+  void
+  CheckRetxTimeout()
+  {
+    std::vector<PartKey> timedOut;
+
+    auto expired = [this, &timedOut](const RetxDeadline& deadline) {
+      auto pending = m_pending.find(deadline.key);
+      if (pending == m_pending.end() || pending->second.generation != deadline.generation) {
+        // Data arrived or the interest was sent again since this deadline was filed
+        return;
+      }
+
+      timedOut.push_back(deadline.key);
+      m_timedOutInterests(this, deadline.key.first);
+    };
+    m_retxWheel.Advance(ToTicks(Simulator::Now(), false), expired);
+
+    if (!timedOut.empty()) {
+      m_rto = std::min(m_rto * 2, Seconds(60));
+      for (const PartKey& key : timedOut) {
+        auto pending = m_pending.find(key);
+        if (pending == m_pending.end()) {
+          // an earlier key dropped the object
+          continue;
+        }
+        if (pending->second.retxCount > m_maxRetx) {
+          Drop(m_objects.find(key.first), "too many retransmissions");
+          continue;
+        }
+        SendInterest(key);
+      }
+      FillPipeline();
+    }
+
+    m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerHealthObject::CheckRetxTimeout, this);
+  }
+
+  bool
+  ParseName(const Name& name, PartKey& key) const
+  {
+    if (name.size() == m_interestName.size() + 1 && name.at(-1).isSequenceNumber()) {
+      key = PartKey(static_cast<uint32_t>(name.at(-1).toSequenceNumber()), MANIFEST);
+      return true;
+    }
+    if (name.size() == m_interestName.size() + 2 && name.at(-2).isSequenceNumber()
+        && name.at(-1).isSegment()) {
+      key = PartKey(static_cast<uint32_t>(name.at(-2).toSequenceNumber()),
+                    static_cast<uint32_t>(name.at(-1).toSegment()));
+      return true;
+    }
+    return false;
+  }
+
+  static uint64_t
+  ReadBigEndian(const uint8_t* pos, size_t size)
+  {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+      value = (value << 8) | pos[i];
+    }
+    return value;
+  }
+
+  /**
+   * \brief Wheel tick of @p time, rounded up for deadlines and down for the current time
+   */
+  uint64_t
+  ToTicks(Time time, bool roundUp) const
+  {
+    int64_t elapsed = (time - m_retxWheelStart).GetTimeStep();
+    int64_t tick = m_retxTimer.GetTimeStep();
+    return static_cast<uint64_t>(roundUp ? (elapsed + tick - 1) / tick : elapsed / tick);
+  }
+
+  void
+  UpdateRto(Time rtt)
+  {
+    if (m_srtt.IsZero()) {
+      m_srtt = rtt;
+      m_rttVar = rtt / 2;
+    }
+    else {
+      Time error = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+      m_rttVar = (m_rttVar * 3 + error) / 4;
+      m_srtt = (m_srtt * 7 + rtt) / 8;
+    }
+    m_rto = std::max(m_srtt + m_rttVar * 4, MilliSeconds(200));
+  }
+
+protected:
+  Name m_interestName;
+  double m_frequency;
+  std::string m_randomType;
+  uint32_t m_seed;
+  uint32_t m_pipeline;
+  uint32_t m_maxRetx;
+  Time m_interestLifeTime;
+  Time m_retxTimer;
+
+  Ptr<UniformRandomVariable> m_rand;
+  ExponentialBatch m_interArrival;
+  uint32_t m_seq;
+  std::map<uint32_t, ObjectState> m_objects;
+  std::map<PartKey, PendingInterest> m_pending;
+  uint32_t m_inFlight;
+
+  EventId m_sendEvent;
+  EventId m_retxEvent;
+  TimerWheel<RetxDeadline> m_retxWheel;
+  Time m_retxWheelStart;
+
+  Time m_srtt;
+  Time m_rttVar;
+  Time m_rto;
+
+  TracedCallback<Ptr<App>, uint32_t, Time, uint64_t, uint32_t, uint32_t> m_objectDelay;
+  TracedCallback<Ptr<App>, uint32_t, uint32_t> m_droppedObject;
+  TracedCallback<Ptr<App>, uint32_t> m_timedOutInterests;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerHealthObject);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // CONSUMER_HEALTH_OBJECT_HPP
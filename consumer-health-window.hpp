@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// consumer-health-window.hpp
+
+#ifndef CONSUMER_HEALTH_WINDOW_HPP
+#define CONSUMER_HEALTH_WINDOW_HPP
+
+#include "ns3/ndnSIM/apps/ndn-consumer.hpp"
+
+#include <limits>
+
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * \brief Window-based (pipelined) variant of ConsumerHealth
+ *
+ * Instead of sending interests at a fixed `Frequency`, the consumer keeps up to
+ * `cwnd` interests in flight and fetches sequence-numbered readings as fast as the
+ * path allows.  The window starts at `InitialWindow`, grows by one per Data in
+ * slow start until it reaches `SlowStartThreshold`, then grows by `AddRate` per
+ * window (additive increase).  A timeout multiplies the window by `Beta`
+ * (multiplicative decrease), at most once per window of data.
+ *
+ * Intended for catching up on a backlog of readings, e.g. after a doctor
+ * reconnects; set `MaxSeq` to the length of the backlog.
+ */
+class ConsumerHealthWindow : public Consumer {
+public:
+  typedef void (*WindowTraceCallback)(double);
+  typedef void (*TimedOutInterestsCallback)(Ptr<App> app, uint32_t seqno);
+
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::ndn::ConsumerHealthWindow")
+        .SetGroupName("Ndn")
+        .SetParent<Consumer>()
+        .AddConstructor<ConsumerHealthWindow>()
+
+        .AddAttribute("InitialWindow", "Initial size of the congestion window (interests)",
+                      DoubleValue(1.0),
+                      MakeDoubleAccessor(&ConsumerHealthWindow::m_initialWindow),
+                      MakeDoubleChecker<double>(1.0))
+        .AddAttribute("SlowStartThreshold", "Initial slow start threshold (interests)",
+                      DoubleValue(std::numeric_limits<double>::max()),
+                      MakeDoubleAccessor(&ConsumerHealthWindow::m_ssthresh),
+                      MakeDoubleChecker<double>(1.0))
+        .AddAttribute("AddRate", "Additive increase per window of data in congestion avoidance",
+                      DoubleValue(1.0),
+                      MakeDoubleAccessor(&ConsumerHealthWindow::m_addRate),
+                      MakeDoubleChecker<double>(0.0))
+        .AddAttribute("Beta", "Multiplicative decrease factor applied on timeout",
+                      DoubleValue(0.5),
+                      MakeDoubleAccessor(&ConsumerHealthWindow::m_beta),
+                      MakeDoubleChecker<double>(0.0, 1.0))
+
+        .AddTraceSource("WindowTrace", "Window that controls how many outstanding interests are allowed",
+                        MakeTraceSourceAccessor(&ConsumerHealthWindow::m_window),
+                        "ns3::ndn::ConsumerHealthWindow::WindowTraceCallback")
+        .AddTraceSource("InFlight", "Current number of outstanding interests",
+                        MakeTraceSourceAccessor(&ConsumerHealthWindow::m_inFlight),
+                        "ns3::ndn::ConsumerHealthWindow::WindowTraceCallback")
+        .AddTraceSource("TimedOutInterests", "Interest whose retransmission timer expired",
+                        MakeTraceSourceAccessor(&ConsumerHealthWindow::m_timedOutInterests),
+                        "ns3::ndn::ConsumerHealthWindow::TimedOutInterestsCallback");
+
+    return tid;
+  }
+
+  ConsumerHealthWindow()
+    : m_initialWindow(1.0)
+    , m_ssthresh(std::numeric_limits<double>::max())
+    , m_addRate(1.0)
+    , m_beta(0.5)
+    , m_recoveryPoint(0)
+    , m_inFlight(0)
+  {
+  }
+
+  virtual void
+  OnData(shared_ptr<const Data> data)
+  {
+    Consumer::OnData(data);
+
+    if (m_inFlight > static_cast<uint32_t>(0)) {
+      m_inFlight--;
+    }
+
+    if (m_window < m_ssthresh) {
+      m_window = m_window + 1.0;
+    }
+    else {
+      m_window = m_window + m_addRate / m_window;
+    }
+
+    ScheduleNextPacket();
+  }
+
+  virtual void
+  OnTimeout(uint32_t sequenceNumber)
+  {
+    m_timedOutInterests(this, sequenceNumber);
+
+    if (m_inFlight > static_cast<uint32_t>(0)) {
+      m_inFlight--;
+    }
+
+    // react to at most one loss per window: losses of interests that were sent
+    // before the previous decrease belong to the same congestion event
+    if (sequenceNumber >= m_recoveryPoint) {
+      m_ssthresh = std::max<double>(m_initialWindow, m_window * m_beta);
+      m_window = m_ssthresh;
+      m_recoveryPoint = m_seq;
+    }
+
+    Consumer::OnTimeout(sequenceNumber);
+  }
+
+  virtual void
+  WillSendOutInterest(uint32_t sequenceNumber)
+  {
+    m_inFlight++;
+    Consumer::WillSendOutInterest(sequenceNumber);
+  }
+
+protected:
+  virtual void
+  StartApplication()
+  {
+    m_window = m_initialWindow;
+    Consumer::StartApplication();
+  }
+
+  virtual void
+  ScheduleNextPacket()
+  {
+    if (m_inFlight >= static_cast<uint32_t>(m_window)) {
+      // window is full, next interest goes out when Data or a timeout frees a slot
+      return;
+    }
+
+    if (m_sendEvent.IsRunning()) {
+      Simulator::Remove(m_sendEvent);
+    }
+    m_sendEvent = Simulator::ScheduleNow(&Consumer::SendPacket, this);
+  }
+
+private:
+  double m_initialWindow;
+  double m_ssthresh;
+  double m_addRate;
+  double m_beta;
+  uint32_t m_recoveryPoint;
+
+  TracedValue<double> m_window;
+  TracedValue<uint32_t> m_inFlight;
+  TracedCallback<Ptr<App>, uint32_t> m_timedOutInterests;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerHealthWindow);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // CONSUMER_HEALTH_WINDOW_HPP
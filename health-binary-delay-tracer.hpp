@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-binary-delay-tracer.hpp
+
+#ifndef HEALTH_BINARY_DELAY_TRACER_HPP
+#define HEALTH_BINARY_DELAY_TRACER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Fixed-size record of one delay sample in a binary delay trace
+ *
+ * Field for field the same sample AppDelayTracer prints as one text line.
+ */
+struct DelayRecord {
+  int64_t time;      ///< simulated time of the sample, nanoseconds
+  int64_t delay;     ///< nanoseconds
+  uint32_t node;     ///< node id, see the name table in the file header
+  uint32_t appId;
+  uint32_t seq;
+  uint32_t retxCount;
+  int32_t hopCount;
+  uint8_t type;      ///< LAST_DELAY or FULL_DELAY
+  uint8_t reserved[3];
+};
+
+/**
+ * \brief AppDelayTracer replacement that writes fixed-size binary records
+ *
+ * The simulation thread only copies a DelayRecord into the active half of a double
+ * buffer; a full half is handed to a background thread that writes it out while
+ * the simulation fills the other half.  The simulation waits only if it fills a
+ * half before the writer finished the previous one.  Nothing is formatted during
+ * Simulator::Run(): `tools/delay-trace-to-text.cpp` turns a trace into the usual
+ * app-delays.txt text on demand.
+ *
+ * File layout (host byte order):
+ *
+ *     "HDLY", uint32 version (1), uint32 record size, uint32 node count
+ *     node count times: uint32 node id, uint32 name length, name bytes
+ *     DelayRecord...
+ *
+ * The trace is flushed and closed when the simulator is destroyed.
+ */
+class BinaryDelayTracer {
+public:
+  enum { LAST_DELAY = 0, FULL_DELAY = 1 };
+
+  static const uint32_t VERSION = 1;
+
+  /**
+   * \brief Trace the delays of all applications on all nodes to @p file
+   *
+   * @param recordsPerBuffer size of each half of the double buffer
+   */
+  static void
+  InstallAll(const std::string& file, size_t recordsPerBuffer = 64 * 1024)
+  {
+    GetInstance().reset(new BinaryDelayTracer(file, recordsPerBuffer));
+    BinaryDelayTracer* tracer = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/LastRetransmittedInterestDataDelay",
+                                  MakeCallback(&BinaryDelayTracer::LastRetransmittedInterestDataDelay,
+                                               tracer));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/FirstInterestDataDelay",
+                                  MakeCallback(&BinaryDelayTracer::FirstInterestDataDelay, tracer));
+
+    Simulator::ScheduleDestroy(&BinaryDelayTracer::Destroy);
+  }
+
+  /**
+   * \brief Write out what is buffered and stop the writer thread
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~BinaryDelayTracer()
+  {
+    Submit();
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wakeup.notify_all();
+    m_writer.join();
+    std::fclose(m_file);
+  }
+
+private:
+  BinaryDelayTracer(const std::string& file, size_t recordsPerBuffer)
+    : m_capacity(recordsPerBuffer)
+    , m_active(0)
+    , m_used(0)
+    , m_pendingBuffer(-1)
+    , m_pendingSize(0)
+    , m_stop(false)
+  {
+    m_file = std::fopen(file.c_str(), "wb");
+    if (m_file == nullptr) {
+      NS_FATAL_ERROR("Cannot open delay trace file " << file);
+    }
+    WriteHeader();
+
+    m_buffers[0].resize(m_capacity);
+    m_buffers[1].resize(m_capacity);
+    m_writer = std::thread(&BinaryDelayTracer::Write, this);
+  }
+
+  static std::unique_ptr<BinaryDelayTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<BinaryDelayTracer> instance;
+    return instance;
+  }
+
+  void
+  WriteHeader()
+  {
+    uint32_t header[] = {0, VERSION, sizeof(DelayRecord), NodeList::GetNNodes()};
+    std::memcpy(header, "HDLY", 4);
+    std::fwrite(header, sizeof(header), 1, m_file);
+
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      std::string name = Names::FindName(*node);
+      uint32_t entry[] = {(*node)->GetId(), static_cast<uint32_t>(name.size())};
+      std::fwrite(entry, sizeof(entry), 1, m_file);
+      std::fwrite(name.data(), 1, name.size(), m_file);
+    }
+  }
+
+  void
+  LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount)
+  {
+    Append(app, seqno, delay, 1, hopCount, LAST_DELAY);
+  }
+
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+  {
+    Append(app, seqno, delay, retxCount, hopCount, FULL_DELAY);
+  }
+
+  void
+  Append(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount, uint8_t type)
+  {
+    DelayRecord& record = m_buffers[m_active][m_used];
+    record.time = Simulator::Now().GetNanoSeconds();
+    record.delay = delay.GetNanoSeconds();
+    record.node = app->GetNode()->GetId();
+    record.appId = app->GetId();
+    record.seq = seqno;
+    record.retxCount = retxCount;
+    record.hopCount = hopCount;
+    record.type = type;
+    std::memset(record.reserved, 0, sizeof(record.reserved));
+
+    if (++m_used == m_capacity) {
+      Submit();
+    }
+  }
+
+  /**
+   * \brief Hand the active half to the writer and continue in the other one
+   */
+  void
+  Submit()
+  {
+    if (m_used == 0) {
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      // the other half is free once the writer is done with it
+      m_done.wait(lock, [this] { return m_pendingBuffer < 0; });
+      m_pendingBuffer = m_active;
+      m_pendingSize = m_used;
+    }
+    m_wakeup.notify_one();
+
+    m_active = 1 - m_active;
+    m_used = 0;
+  }
+
+  /**
+   * \brief Writer thread: write out every submitted half until stopped
+   */
+  void
+  Write()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+      m_wakeup.wait(lock, [this] { return m_pendingBuffer >= 0 || m_stop; });
+      if (m_pendingBuffer < 0) {
+        return; // stopped and nothing left to write
+      }
+
+      const DelayRecord* records = &m_buffers[m_pendingBuffer][0];
+      size_t size = m_pendingSize;
+      lock.unlock();
+      std::fwrite(records, sizeof(DelayRecord), size, m_file);
+      lock.lock();
+
+      m_pendingBuffer = -1;
+      m_done.notify_one();
+    }
+  }
+
+private:
+  std::FILE* m_file;
+  std::vector<DelayRecord> m_buffers[2];
+  size_t m_capacity;
+  int m_active;  ///< half the simulation appends to
+  size_t m_used; ///< records in the active half
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  std::condition_variable m_done;
+  int m_pendingBuffer; ///< half being written, -1 if none
+  size_t m_pendingSize;
+  bool m_stop;
+  std::thread m_writer;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_BINARY_DELAY_TRACER_HPP
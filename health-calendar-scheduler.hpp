@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-calendar-scheduler.hpp
+
+#ifndef HEALTH_CALENDAR_SCHEDULER_HPP
+#define HEALTH_CALENDAR_SCHEDULER_HPP
+
+#include "ns3/assert.h"
+#include "ns3/scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Calendar queue (Brown, 1988) with an adaptive bucket width
+ *
+ * Events are hashed by timestamp into a power-of-two number of buckets, each one
+ * `width` time steps wide and kept sorted with the earliest event at the back.
+ * The next event is found by walking the buckets from the current one, so insert
+ * and remove are O(1) amortized as long as a bucket holds a few events: the
+ * number of buckets follows the number of events (doubled above 2 per bucket,
+ * halved below 1/2), and on every resize the width is set to three times the
+ * mean gap between the earliest events.  If a whole pass over the buckets finds
+ * nothing (all events are far in the future), the earliest bucket head is taken
+ * directly and the width is retuned after a while.
+ *
+ * Periodic consumers and fixed link delays keep the event times densely and
+ * evenly spread, which is the case calendar queues are good at.  Select it with
+ *
+ *     Simulator::SetScheduler(ObjectFactory("ns3::ndn::CalendarQueueScheduler"));
+ *
+ * `tools/scheduler-replay.cpp` checks its ordering against MapScheduler and times
+ * both on synthetic event streams.
+ */
+class CalendarQueueScheduler : public Scheduler {
+public:
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid = TypeId("ns3::ndn::CalendarQueueScheduler")
+                          .SetParent<Scheduler>()
+                          .SetGroupName("Ndn")
+                          .AddConstructor<CalendarQueueScheduler>();
+
+    return tid;
+  }
+
+  CalendarQueueScheduler()
+    : m_buckets(MIN_BUCKETS)
+    , m_width(1)
+    , m_count(0)
+    , m_bucket(0)
+    , m_bucketTop(1)
+    , m_lastTs(0)
+    , m_removals(0)
+  {
+  }
+
+  virtual void
+  Insert(const Event& ev)
+  {
+    Bucket& bucket = m_buckets[GetBucket(ev.key.m_ts)];
+    bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), ev, &IsLater), ev);
+
+    if (++m_count > 2 * m_buckets.size()) {
+      Resize(m_buckets.size() * 2);
+    }
+  }
+
+  virtual bool
+  IsEmpty() const
+  {
+    return m_count == 0;
+  }
+
+  virtual Event
+  PeekNext() const
+  {
+    NS_ASSERT(m_count > 0);
+    bool direct;
+    return m_buckets[FindNext(direct)].back();
+  }
+
+  virtual Event
+  RemoveNext()
+  {
+    NS_ASSERT(m_count > 0);
+    bool direct;
+    Bucket& bucket = m_buckets[FindNext(direct)];
+    Event ev = bucket.back();
+    bucket.pop_back();
+    --m_count;
+
+    SetCurrent(ev.key.m_ts);
+    ++m_removals;
+
+    if (m_count < m_buckets.size() / 2 && m_buckets.size() > MIN_BUCKETS) {
+      Resize(m_buckets.size() / 2);
+    }
+    else if (direct && m_removals >= m_buckets.size()) {
+      Resize(m_buckets.size());
+    }
+    return ev;
+  }
+
+  virtual void
+  Remove(const Event& ev)
+  {
+    Bucket& bucket = m_buckets[GetBucket(ev.key.m_ts)];
+    Bucket::iterator it = std::lower_bound(bucket.begin(), bucket.end(), ev, &IsLater);
+    NS_ASSERT(it != bucket.end() && it->key.m_uid == ev.key.m_uid);
+    bucket.erase(it);
+    --m_count;
+  }
+
+private:
+  typedef std::vector<Event> Bucket;
+
+  enum : size_t { MIN_BUCKETS = 16, WIDTH_SAMPLE = 25 };
+
+  static bool
+  IsLater(const Event& a, const Event& b)
+  {
+    return b.key < a.key;
+  }
+
+  size_t
+  GetBucket(uint64_t ts) const
+  {
+    return static_cast<size_t>(ts / m_width) & (m_buckets.size() - 1);
+  }
+
+  void
+  SetCurrent(uint64_t ts)
+  {
+    m_lastTs = ts;
+    m_bucket = GetBucket(ts);
+    m_bucketTop = (ts / m_width + 1) * m_width;
+  }
+
+  /**
+   * \brief Index of the bucket that holds the earliest event
+   *
+   * @param direct set if no bucket had an event in the current pass
+   */
+  size_t
+  FindNext(bool& direct) const
+  {
+    // nothing is ever scheduled before m_lastTs, so a bucket head below the top of
+    // the bucket's current window is the earliest event
+    size_t index = m_bucket;
+    uint64_t top = m_bucketTop;
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+      const Bucket& bucket = m_buckets[index];
+      if (!bucket.empty() && bucket.back().key.m_ts < top) {
+        direct = false;
+        return index;
+      }
+      index = (index + 1) & (m_buckets.size() - 1);
+      top += m_width;
+    }
+
+    direct = true;
+    size_t earliest = m_buckets.size();
+    for (index = 0; index < m_buckets.size(); ++index) {
+      if (!m_buckets[index].empty()
+          && (earliest == m_buckets.size() || m_buckets[index].back().key < m_buckets[earliest].back().key)) {
+        earliest = index;
+      }
+    }
+    return earliest;
+  }
+
+  void
+  Resize(size_t buckets)
+  {
+    std::vector<Event> events;
+    events.reserve(m_count);
+    for (const Bucket& bucket : m_buckets) {
+      events.insert(events.end(), bucket.begin(), bucket.end());
+    }
+    std::sort(events.begin(), events.end(), &IsLater);
+
+    // cleared buckets keep their capacity, so a steady queue stops allocating
+    m_width = EstimateWidth(events);
+    for (Bucket& bucket : m_buckets) {
+      bucket.clear();
+    }
+    m_buckets.resize(buckets);
+    for (const Event& ev : events) {
+      m_buckets[GetBucket(ev.key.m_ts)].push_back(ev);
+    }
+
+    SetCurrent(m_lastTs);
+    m_removals = 0;
+  }
+
+  /**
+   * \brief Three times the mean gap between the earliest events, ignoring gaps
+   *        more than twice the plain mean (@p events is sorted latest first)
+   */
+  uint64_t
+  EstimateWidth(const std::vector<Event>& events) const
+  {
+    size_t sample = std::min<size_t>(events.size(), WIDTH_SAMPLE);
+    if (sample < 2) {
+      return m_width;
+    }
+
+    const Event* earliest = &events[events.size() - sample];
+    uint64_t span = earliest[0].key.m_ts - earliest[sample - 1].key.m_ts;
+    uint64_t mean = span / (sample - 1);
+
+    uint64_t sum = 0;
+    uint64_t gaps = 0;
+    for (size_t i = 0; i + 1 < sample; ++i) {
+      uint64_t gap = earliest[i].key.m_ts - earliest[i + 1].key.m_ts;
+      if (gap <= 2 * mean) {
+        sum += gap;
+        ++gaps;
+      }
+    }
+
+    uint64_t width = gaps > 0 ? 3 * sum / gaps : 0;
+    return width > 0 ? width : m_width;
+  }
+
+private:
+  std::vector<Bucket> m_buckets; ///< size is a power of two
+  uint64_t m_width;              ///< time steps per bucket
+  size_t m_count;
+  size_t m_bucket;               ///< bucket of the last removed event
+  uint64_t m_bucketTop;          ///< end of that bucket's current window
+  uint64_t m_lastTs;             ///< timestamp of the last removed event
+  size_t m_removals;             ///< since the last resize
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CalendarQueueScheduler);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_CALENDAR_SCHEDULER_HPP
@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-columnar-delay-tracer.hpp
+
+#ifndef HEALTH_COLUMNAR_DELAY_TRACER_HPP
+#define HEALTH_COLUMNAR_DELAY_TRACER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief AppDelayTracer replacement that writes the samples column by column
+ *
+ * Samples are collected into row groups of `rowsPerGroup` rows; each full group is
+ * written as one block per column, so an analysis that needs only the delays reads
+ * (or maps) only the delay blocks.  Integers are in host byte order and every
+ * column block starts at a multiple of 8 bytes from the beginning of the file:
+ *
+ *     file      "HCOL", uint32 version (1), row group..., footer,
+ *               uint64 footer offset, "HCOL"
+ *     row group uint32 rows, uint32 time block size, then the column blocks
+ *               time       LEB128 varints: first row absolute ns, then deltas
+ *               node       uint32 per row, index into the node dictionary
+ *               app        uint32 per row
+ *               seq        uint32 per row
+ *               type       uint8 per row, 0 LastDelay / 1 FullDelay
+ *               delay      int64 ns per row
+ *               retx       uint32 per row
+ *               hop        int32 per row
+ *     footer    uint32 dictionary size, per entry uint32 length + name bytes,
+ *               uint32 row group count, per group uint64 offset + uint32 rows
+ *
+ * Node names are dictionary encoded in order of first appearance (nodes without
+ * a name use their id).  Timestamps never decrease, so their deltas are small and
+ * mostly take one or two bytes.  `tools/delay-columns.cpp` reads these files.
+ */
+class ColumnarDelayTracer {
+public:
+  static const uint32_t VERSION = 1;
+
+  /**
+   * \brief Trace the delays of all applications on all nodes to @p file
+   */
+  static void
+  InstallAll(const std::string& file, size_t rowsPerGroup = 64 * 1024)
+  {
+    GetInstance().reset(new ColumnarDelayTracer(file, rowsPerGroup));
+    ColumnarDelayTracer* tracer = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/LastRetransmittedInterestDataDelay",
+                                  MakeCallback(&ColumnarDelayTracer::LastRetransmittedInterestDataDelay,
+                                               tracer));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/FirstInterestDataDelay",
+                                  MakeCallback(&ColumnarDelayTracer::FirstInterestDataDelay, tracer));
+
+    Simulator::ScheduleDestroy(&ColumnarDelayTracer::Destroy);
+  }
+
+  /**
+   * \brief Write the last row group and the footer and close the file
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~ColumnarDelayTracer()
+  {
+    WriteGroup();
+
+    uint64_t footerOffset = m_offset;
+    WriteValue<uint32_t>(m_dictionary.size());
+    for (const std::string& name : m_dictionary) {
+      WriteValue<uint32_t>(name.size());
+      WriteBytes(name.data(), name.size());
+    }
+    WriteValue<uint32_t>(m_groups.size());
+    for (const auto& group : m_groups) {
+      WriteValue<uint64_t>(group.first);
+      WriteValue<uint32_t>(group.second);
+    }
+    WriteValue<uint64_t>(footerOffset);
+    WriteBytes("HCOL", 4);
+
+    std::fclose(m_file);
+  }
+
+private:
+  ColumnarDelayTracer(const std::string& file, size_t rowsPerGroup)
+    : m_rowsPerGroup(rowsPerGroup)
+    , m_offset(0)
+    , m_lastTime(0)
+  {
+    m_file = std::fopen(file.c_str(), "wb");
+    if (m_file == nullptr) {
+      NS_FATAL_ERROR("Cannot open columnar delay trace file " << file);
+    }
+
+    WriteBytes("HCOL", 4);
+    WriteValue<uint32_t>(VERSION);
+    Reserve();
+  }
+
+  static std::unique_ptr<ColumnarDelayTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<ColumnarDelayTracer> instance;
+    return instance;
+  }
+
+  void
+  Reserve()
+  {
+    m_time.reserve(m_rowsPerGroup * 2);
+    m_node.reserve(m_rowsPerGroup);
+    m_app.reserve(m_rowsPerGroup);
+    m_seq.reserve(m_rowsPerGroup);
+    m_type.reserve(m_rowsPerGroup);
+    m_delay.reserve(m_rowsPerGroup);
+    m_retx.reserve(m_rowsPerGroup);
+    m_hop.reserve(m_rowsPerGroup);
+  }
+
+  void
+  LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount)
+  {
+    Append(app, seqno, delay, 1, hopCount, 0);
+  }
+
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+  {
+    Append(app, seqno, delay, retxCount, hopCount, 1);
+  }
+
+  void
+  Append(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount, uint8_t type)
+  {
+    uint64_t now = static_cast<uint64_t>(Simulator::Now().GetNanoSeconds());
+    AppendVarNumber(m_node.empty() ? now : now - m_lastTime);
+    m_lastTime = now;
+
+    m_node.push_back(GetNodeCode(app->GetNode()->GetId()));
+    m_app.push_back(app->GetId());
+    m_seq.push_back(seqno);
+    m_type.push_back(type);
+    m_delay.push_back(delay.GetNanoSeconds());
+    m_retx.push_back(retxCount);
+    m_hop.push_back(hopCount);
+
+    if (m_node.size() == m_rowsPerGroup) {
+      WriteGroup();
+    }
+  }
+
+  uint32_t
+  GetNodeCode(uint32_t nodeId)
+  {
+    if (nodeId >= m_nodeCodes.size()) {
+      m_nodeCodes.resize(nodeId + 1, UNKNOWN);
+    }
+
+    uint32_t& code = m_nodeCodes[nodeId];
+    if (code == UNKNOWN) {
+      std::string name = Names::FindName(NodeList::GetNode(nodeId));
+      code = static_cast<uint32_t>(m_dictionary.size());
+      m_dictionary.push_back(name.empty() ? std::to_string(nodeId) : name);
+    }
+    return code;
+  }
+
+  void
+  AppendVarNumber(uint64_t value)
+  {
+    while (value >= 0x80) {
+      m_time.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    m_time.push_back(static_cast<uint8_t>(value));
+  }
+
+  void
+  WriteGroup()
+  {
+    if (m_node.empty()) {
+      return;
+    }
+
+    m_groups.push_back(std::make_pair(m_offset, static_cast<uint32_t>(m_node.size())));
+    WriteValue<uint32_t>(m_node.size());
+    WriteValue<uint32_t>(m_time.size());
+
+    WriteColumn(m_time);
+    WriteColumn(m_node);
+    WriteColumn(m_app);
+    WriteColumn(m_seq);
+    WriteColumn(m_type);
+    WriteColumn(m_delay);
+    WriteColumn(m_retx);
+    WriteColumn(m_hop);
+
+    m_time.clear();
+    m_node.clear();
+    m_app.clear();
+    m_seq.clear();
+    m_type.clear();
+    m_delay.clear();
+    m_retx.clear();
+    m_hop.clear();
+  }
+
+  template<typename T>
+  void
+  WriteColumn(const std::vector<T>& column)
+  {
+    static const char padding[8] = {0};
+    WriteBytes(padding, (8 - m_offset % 8) % 8);
+    WriteBytes(column.data(), column.size() * sizeof(T));
+  }
+
+  template<typename T>
+  void
+  WriteValue(T value)
+  {
+    WriteBytes(&value, sizeof(value));
+  }
+
+  void
+  WriteBytes(const void* data, size_t size)
+  {
+    std::fwrite(data, 1, size, m_file);
+    m_offset += size;
+  }
+
+private:
+  enum : uint32_t { UNKNOWN = 0xFFFFFFFF }; ///< node without a dictionary code yet
+
+  std::FILE* m_file;
+  size_t m_rowsPerGroup;
+  uint64_t m_offset;
+  uint64_t m_lastTime;
+
+  std::vector<uint8_t> m_time;
+  std::vector<uint32_t> m_node;
+  std::vector<uint32_t> m_app;
+  std::vector<uint32_t> m_seq;
+  std::vector<uint8_t> m_type;
+  std::vector<int64_t> m_delay;
+  std::vector<uint32_t> m_retx;
+  std::vector<int32_t> m_hop;
+
+  std::vector<uint32_t> m_nodeCodes; ///< node id -> dictionary code
+  std::vector<std::string> m_dictionary;
+  std::vector<std::pair<uint64_t, uint32_t>> m_groups;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_COLUMNAR_DELAY_TRACER_HPP
@@ -0,0 +1,375 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-delay-histogram-tracer.hpp
+
+#ifndef HEALTH_DELAY_HISTOGRAM_TRACER_HPP
+#define HEALTH_DELAY_HISTOGRAM_TRACER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Log-linear (HDR-style) histogram of non-negative integer values
+ *
+ * Values below 2^SUB_BUCKET_BITS get a bucket each; above that every power of two
+ * is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so a reported percentile is
+ * within 1 / 2^(SUB_BUCKET_BITS - 1) of the true value whatever its magnitude.
+ * Recording is a couple of shifts and an increment; buckets are allocated as
+ * larger values show up.
+ */
+class LogLinearHistogram {
+public:
+  static const unsigned SUB_BUCKET_BITS = 7;
+  static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+
+  LogLinearHistogram()
+  {
+    Reset();
+  }
+
+  void
+  Reset()
+  {
+    m_counts.clear();
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<uint64_t>::max();
+    m_max = 0;
+  }
+
+  void
+  Record(uint64_t value)
+  {
+    size_t index = GetIndex(value);
+    if (index >= m_counts.size()) {
+      m_counts.resize(index + 1, 0);
+    }
+    ++m_counts[index];
+
+    ++m_count;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+  }
+
+  /**
+   * \brief Add all values recorded in @p other
+   */
+  void
+  Add(const LogLinearHistogram& other)
+  {
+    if (other.m_counts.size() > m_counts.size()) {
+      m_counts.resize(other.m_counts.size(), 0);
+    }
+    for (size_t index = 0; index < other.m_counts.size(); ++index) {
+      m_counts[index] += other.m_counts[index];
+    }
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  uint64_t
+  GetCount() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  GetMin() const
+  {
+    return m_count == 0 ? 0 : m_min;
+  }
+
+  uint64_t
+  GetMax() const
+  {
+    return m_max;
+  }
+
+  double
+  GetMean() const
+  {
+    return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / m_count;
+  }
+
+  /**
+   * \brief Smallest recorded value (to bucket precision) at or above the @p quantile
+   *        fraction of all values, e.g. 0.99 for the 99th percentile
+   */
+  uint64_t
+  GetQuantile(double quantile) const
+  {
+    if (m_count == 0) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(quantile * m_count + 0.5);
+    rank = std::min(std::max<uint64_t>(rank, 1), m_count);
+
+    uint64_t seen = 0;
+    for (size_t index = 0; index < m_counts.size(); ++index) {
+      seen += m_counts[index];
+      if (seen >= rank) {
+        return std::min(std::max(GetUpperBound(index), m_min), m_max);
+      }
+    }
+    return m_max;
+  }
+
+private:
+  static size_t
+  GetIndex(uint64_t value)
+  {
+    if (value < SUB_BUCKETS) {
+      return static_cast<size_t>(value);
+    }
+
+    unsigned shift = 0;
+    while ((value >> shift) >= SUB_BUCKETS) {
+      ++shift;
+    }
+    // value >> shift lies in [SUB_BUCKETS / 2, SUB_BUCKETS)
+    return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS
+                               + ((value >> shift) - HALF_SUB_BUCKETS));
+  }
+
+  static uint64_t
+  GetUpperBound(size_t index)
+  {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+
+    uint64_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t top = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+  }
+
+private:
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+/**
+ * \brief AppDelayTracer replacement that keeps delay histograms instead of samples
+ *
+ * Every full delay (first interest to Data, what AppDelayTracer calls FullDelay)
+ * is recorded in microseconds into a LogLinearHistogram keyed by node, application,
+ * prefix and DiseaseRank.  The prefix is the name of the Data that produced the
+ * sample without its trailing sequence and segment numbers; the rank is byte 1 of
+ * its content (the HealthProducerExt content header), 0 when the content is
+ * shorter.
+ *
+ * Every `period` the tracer writes one `Interval` line per key with the
+ * percentiles of the samples since the previous snapshot, and when the simulator
+ * is destroyed one `Total` line per key over the whole run.  Columns:
+ *
+ *     Time Node AppId Prefix Rank Period Count MinUS P50US P90US P99US P999US MaxUS MeanUS
+ */
+class DelayHistogramTracer {
+public:
+  /**
+   * \brief Trace the delays of all applications on all nodes to @p file
+   *
+   * @param period time between snapshots, zero for the final summary only
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(10))
+  {
+    GetInstance().reset(new DelayHistogramTracer(file, period));
+    DelayHistogramTracer* tracer = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/ReceivedDatas",
+                                  MakeCallback(&DelayHistogramTracer::ReceivedData, tracer));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/FirstInterestDataDelay",
+                                  MakeCallback(&DelayHistogramTracer::FirstInterestDataDelay, tracer));
+
+    Simulator::ScheduleDestroy(&DelayHistogramTracer::Destroy);
+  }
+
+  /**
+   * \brief Write the final summary and close the file
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~DelayHistogramTracer()
+  {
+    Simulator::Cancel(m_snapshotEvent);
+    Snapshot(false);
+
+    for (auto& entry : m_entries) {
+      Print(entry.first, "Total", entry.second.total);
+    }
+  }
+
+private:
+  /// node, application id, prefix, rank
+  typedef std::tuple<uint32_t, uint32_t, Name, uint32_t> Key;
+
+  struct Entry {
+    LogLinearHistogram interval;
+    LogLinearHistogram total;
+  };
+
+  DelayHistogramTracer(const std::string& file, Time period)
+    : m_os(file.c_str(), std::ios_base::out | std::ios_base::trunc)
+    , m_period(period)
+  {
+    if (!m_os.is_open()) {
+      NS_FATAL_ERROR("Cannot open delay histogram file " << file);
+    }
+
+    m_os << "Time\tNode\tAppId\tPrefix\tRank\tPeriod\tCount\tMinUS\tP50US\tP90US\tP99US\tP999US\tMaxUS\tMeanUS"
+         << "\n";
+
+    if (!m_period.IsZero()) {
+      m_snapshotEvent = Simulator::Schedule(m_period, &DelayHistogramTracer::Snapshot, this, true);
+    }
+  }
+
+  static std::unique_ptr<DelayHistogramTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<DelayHistogramTracer> instance;
+    return instance;
+  }
+
+  /**
+   * \brief Remember the Data an application received; its delay is reported right after
+   */
+  void
+  ReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face)
+  {
+    m_lastData[app->GetId() + (static_cast<uint64_t>(app->GetNode()->GetId()) << 32)] = data;
+  }
+
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+  {
+    Name prefix;
+    uint32_t rank = 0;
+
+    auto data = m_lastData.find(app->GetId() + (static_cast<uint64_t>(app->GetNode()->GetId()) << 32));
+    if (data != m_lastData.end()) {
+      prefix = data->second->getName();
+      while (!prefix.empty() && (prefix.at(-1).isSequenceNumber() || prefix.at(-1).isSegment())) {
+        prefix = prefix.getPrefix(-1);
+      }
+
+      const Block& content = data->second->getContent();
+      if (content.value_size() >= 2) {
+        rank = content.value()[1];
+      }
+      m_lastData.erase(data);
+    }
+
+    Key key(app->GetNode()->GetId(), app->GetId(), prefix, rank);
+    m_entries[key].interval.Record(static_cast<uint64_t>(std::max<int64_t>(delay.GetMicroSeconds(), 0)));
+  }
+
+  /**
+   * \brief Print the interval histograms (if @p print) and fold them into the totals
+   */
+  void
+  Snapshot(bool print)
+  {
+    for (auto& entry : m_entries) {
+      if (print && entry.second.interval.GetCount() > 0) {
+        Print(entry.first, "Interval", entry.second.interval);
+      }
+      entry.second.total.Add(entry.second.interval);
+      entry.second.interval.Reset();
+    }
+
+    if (print) {
+      m_os.flush();
+      m_snapshotEvent = Simulator::Schedule(m_period, &DelayHistogramTracer::Snapshot, this, true);
+    }
+  }
+
+  void
+  Print(const Key& key, const char* period, const LogLinearHistogram& histogram)
+  {
+    m_os << Simulator::Now().ToDouble(Time::S) << "\t" << GetNodeName(std::get<0>(key)) << "\t"
+         << std::get<1>(key) << "\t" << std::get<2>(key) << "\t" << std::get<3>(key) << "\t" << period
+         << "\t" << histogram.GetCount() << "\t" << histogram.GetMin() << "\t"
+         << histogram.GetQuantile(0.5) << "\t" << histogram.GetQuantile(0.9) << "\t"
+         << histogram.GetQuantile(0.99) << "\t" << histogram.GetQuantile(0.999) << "\t"
+         << histogram.GetMax() << "\t" << histogram.GetMean() << "\n";
+  }
+
+  std::string
+  GetNodeName(uint32_t nodeId)
+  {
+    std::string& name = m_nodeNames[nodeId];
+    if (name.empty()) {
+      name = Names::FindName(NodeList::GetNode(nodeId));
+      if (name.empty()) {
+        name = std::to_string(nodeId);
+      }
+    }
+    return name;
+  }
+
+private:
+  std::ofstream m_os;
+  Time m_period;
+  EventId m_snapshotEvent;
+
+  std::map<uint64_t, shared_ptr<const Data>> m_lastData;
+  std::map<Key, Entry> m_entries;
+  std::map<uint32_t, std::string> m_nodeNames;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_DELAY_HISTOGRAM_TRACER_HPP
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-exponential-batch.hpp
+
+#ifndef HEALTH_EXPONENTIAL_BATCH_HPP
+#define HEALTH_EXPONENTIAL_BATCH_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Block generator of exponentially distributed inter-arrival times
+ *
+ * Replaces one ns-3 RandomVariableStream call per interest with a block refill
+ * every `blockSize` draws.  Uniforms come from LANES independent xorshift32
+ * generators advanced side by side, so the refill loop has no dependency between
+ * lanes and the compiler can keep all lanes in one SIMD register; the logarithm
+ * pass is a separate flat loop over the block.
+ *
+ * The block holds unit-mean variates and GetValue() scales them, so the rate can
+ * change between draws without discarding the block.  The sequence is a pure
+ * function of the seed: the same `Seed` gives the same schedule on every run.
+ */
+class ExponentialBatch {
+public:
+  static const size_t LANES = 8;
+
+  /**
+   * @param blockSize draws per refill, rounded up to a multiple of LANES (at least one)
+   */
+  explicit ExponentialBatch(uint64_t seed = 1, size_t blockSize = 512)
+    : m_uniform(blockSize > LANES ? (blockSize + LANES - 1) / LANES * LANES : LANES)
+    , m_block(m_uniform.size())
+  {
+    Reseed(seed);
+  }
+
+  /**
+   * \brief Restart the sequence from @p seed, dropping the rest of the current block
+   */
+  void
+  Reseed(uint64_t seed)
+  {
+    // splitmix64 spreads neighbouring seeds over the whole lane state space
+    uint64_t z = seed;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      z += 0x9E3779B97F4A7C15ULL;
+      uint64_t x = z;
+      x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+      x = x ^ (x >> 31);
+      m_state[lane] = static_cast<uint32_t>(x) | 1; // xorshift state must not be zero
+    }
+    m_pos = m_block.size();
+  }
+
+  /**
+   * \brief Next exponentially distributed value with the given @p mean
+   */
+  double
+  GetValue(double mean)
+  {
+    if (m_pos == m_block.size()) {
+      Refill();
+    }
+    return m_block[m_pos++] * mean;
+  }
+
+private:
+  void
+  Refill()
+  {
+    const size_t size = m_block.size();
+    uint32_t state[LANES];
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      state[lane] = m_state[lane];
+    }
+
+    for (size_t i = 0; i < size; i += LANES) {
+      for (size_t lane = 0; lane < LANES; ++lane) {
+        uint32_t x = state[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[lane] = x;
+        // (x + 0.5) / 2^32 lies strictly inside (0, 1), so log() below is finite
+        m_uniform[i + lane] = (static_cast<double>(x) + 0.5) * (1.0 / 4294967296.0);
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      m_block[i] = -std::log(m_uniform[i]);
+    }
+
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      m_state[lane] = state[lane];
+    }
+    m_pos = 0;
+  }
+
+private:
+  uint32_t m_state[LANES];
+  std::vector<double> m_uniform;
+  std::vector<double> m_block;
+  size_t m_pos;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_EXPONENTIAL_BATCH_HPP
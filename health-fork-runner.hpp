@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-fork-runner.hpp
+
+#ifndef HEALTH_FORK_RUNNER_HPP
+#define HEALTH_FORK_RUNNER_HPP
+
+#include "ns3/application.h"
+#include "ns3/fatal-error.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Runs the warm-up once, then fork()s one process per seed to finish the run
+ *
+ * Fork() runs the simulation up to `warmup` in the calling process and forks
+ * `children` copies of it, at most `parallel` at a time (0: all at once).  Each
+ * child gets its own directory `seed-<i>` as working directory, so tracers that
+ * write to relative paths do not collide, and adds `i * SEED_STRIDE` to the `Seed`
+ * attribute of every application that has one (child 0 continues exactly as an
+ * unforked run would, so it keeps its seeds and streams untouched).  Streams created
+ * before the fork would give every child the same numbers, so in the other children
+ * applications with a random `Randomize` (e.g. ndn::ConsumerCbr) get it set again,
+ * which recreates their stream from the child's run number.
+ * @p setup can change anything else per child; without it, Fork() refuses to run
+ * if no application has either attribute, as all children would be identical.
+ *
+ * Fork() returns the child index in each child, which then installs its tracers and
+ * calls Simulator::Run() as usual, and -1 in the parent once all children have
+ * exited.  Tracers and threads must be set up after Fork(): a forked process only
+ * keeps the thread that called fork().
+ *
+ *     Simulator::Stop(Seconds(50.0));
+ *     if (ndn::ForkRunner::Fork(Seconds(10.0), 8) < 0) {
+ *       Simulator::Destroy();
+ *       return 0;
+ *     }
+ *     ndn::AppDelayTracer::InstallAll("app-delays.txt");
+ *     Simulator::Run();
+ */
+class ForkRunner {
+public:
+  enum : uint32_t { SEED_STRIDE = 1000 };
+
+  static int
+  Fork(Time warmup, uint32_t children, uint32_t parallel = 0,
+       std::function<void(uint32_t)> setup = std::function<void(uint32_t)>())
+  {
+    if (!setup && !HasSeededApplications()) {
+      NS_FATAL_ERROR("No application has a Seed or a random Randomize attribute, "
+                     "every forked run would be identical");
+    }
+
+    Simulator::Stop(warmup);
+    Simulator::Run();
+
+    // buffered output would otherwise be written once per child
+    std::cout.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+
+    uint32_t running = 0;
+    uint32_t failed = 0;
+    for (uint32_t child = 0; child < children; ++child) {
+      if (parallel > 0 && running >= parallel) {
+        failed += Wait() ? 0 : 1;
+        --running;
+      }
+
+      pid_t pid = fork();
+      if (pid < 0) {
+        NS_FATAL_ERROR("Cannot fork child " << child);
+      }
+      if (pid == 0) {
+        SetUpChild(child);
+        if (setup) {
+          setup(child);
+        }
+        return static_cast<int>(child);
+      }
+      ++running;
+    }
+
+    for (; running > 0; --running) {
+      failed += Wait() ? 0 : 1;
+    }
+    if (failed > 0) {
+      std::cerr << failed << " of " << children << " forked runs failed" << std::endl;
+    }
+    return -1;
+  }
+
+private:
+  static void
+  SetUpChild(uint32_t child)
+  {
+    std::string directory = "seed-" + std::to_string(child);
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+      NS_FATAL_ERROR("Cannot create " << directory);
+    }
+    if (chdir(directory.c_str()) != 0) {
+      NS_FATAL_ERROR("Cannot enter " << directory);
+    }
+    if (child == 0) {
+      // setting Seed or Randomize would restart the streams mid-run
+      return;
+    }
+
+    // streams created from now on differ per child as well
+    RngSeedManager::SetRun(RngSeedManager::GetRun() + child);
+
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); ++i) {
+        Ptr<Application> app = (*node)->GetApplication(i);
+        if (HasSeed(app)) {
+          UintegerValue seed;
+          app->GetAttribute("Seed", seed);
+          app->SetAttribute("Seed", UintegerValue(seed.Get() + child * SEED_STRIDE));
+        }
+
+        std::string randomize;
+        if (HasRandomize(app, randomize)) {
+          app->SetAttribute("Randomize", StringValue(randomize));
+        }
+      }
+    }
+  }
+
+  static bool
+  HasSeededApplications()
+  {
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); ++i) {
+        std::string randomize;
+        if (HasSeed((*node)->GetApplication(i)) || HasRandomize((*node)->GetApplication(i), randomize)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * \brief Whether @p app has an unsigned integer `Seed` attribute
+   */
+  static bool
+  HasSeed(Ptr<Application> app)
+  {
+    TypeId::AttributeInformation info;
+    return app->GetInstanceTypeId().LookupAttributeByName("Seed", &info)
+           && info.checker->GetValueTypeName() == "ns3::UintegerValue";
+  }
+
+  /**
+   * \brief Whether @p app has a `Randomize` attribute other than "none"
+   *
+   * @param randomize set to its value
+   */
+  static bool
+  HasRandomize(Ptr<Application> app, std::string& randomize)
+  {
+    TypeId::AttributeInformation info;
+    if (!app->GetInstanceTypeId().LookupAttributeByName("Randomize", &info)) {
+      return false;
+    }
+
+    StringValue value;
+    app->GetAttribute("Randomize", value);
+    randomize = value.Get();
+    return !randomize.empty() && randomize != "none";
+  }
+
+  /**
+   * \brief Wait for one child; false if it did not exit with status 0
+   */
+  static bool
+  Wait()
+  {
+    int status = 0;
+    pid_t pid;
+    do {
+      pid = wait(&status);
+    } while (pid < 0 && errno == EINTR);
+    return pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_FORK_RUNNER_HPP
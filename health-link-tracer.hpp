@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-link-tracer.hpp
+
+#ifndef HEALTH_LINK_TRACER_HPP
+#define HEALTH_LINK_TRACER_HPP
+
+#include "ns3/data-rate.h"
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Per-period statistics of one direction of a point-to-point link
+ */
+struct LinkRecord {
+  int64_t time;         ///< end of the period, nanoseconds
+  uint32_t link;        ///< index into the link table
+  uint32_t maxQueue;    ///< packets
+  double meanQueue;     ///< time-weighted, packets
+  double utilization;   ///< dequeued bits / (DataRate * period)
+  uint32_t enqueues;
+  uint32_t dequeues;
+  uint32_t drops[3];    ///< Interest, Data, other
+  uint32_t reserved;
+};
+
+/**
+ * \brief Queue occupancy, rate, drop and utilization tracer for point-to-point links
+ *
+ * Hooks the Enqueue, Dequeue and Drop traces of the transmit queue of every
+ * PointToPointNetDevice directly (no Config path matching per packet), so each
+ * packet costs a few counter updates.  Drops are classified by the NDN TLV type
+ * that follows the 2-byte PPP header (0x05 Interest, 0x06 Data).
+ *
+ * Every `period` one LinkRecord per link direction is written to a binary file:
+ *
+ *     "HLNK", uint32 version (1), uint32 record size, uint32 link count,
+ *     link count times: uint32 queue limit (packets, 0 if unknown), uint64 data rate
+ *       (bit/s), uint32 name length, name ("From->To")
+ *     LinkRecord...
+ *     footer: per link, QUEUE_BUCKETS uint64 counts of the queue length seen by
+ *       arriving packets (the last bucket also counts longer queues), then "HLNK"
+ *
+ * `tools/link-trace-to-text.cpp` prints the records and ranks links by drops and
+ * utilization.
+ */
+class LinkQueueTracer {
+public:
+  static const uint32_t VERSION = 1;
+  static const uint32_t QUEUE_BUCKETS = 64;
+
+  enum { INTEREST = 0, DATA = 1, OTHER = 2 };
+
+  /**
+   * \brief Trace every point-to-point device on every node to @p file
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(1))
+  {
+    GetInstance().reset(new LinkQueueTracer(file, period));
+    Simulator::ScheduleDestroy(&LinkQueueTracer::Destroy);
+  }
+
+  /**
+   * \brief Write the last period and the queue length histograms and close the file
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~LinkQueueTracer()
+  {
+    Simulator::Cancel(m_event);
+    Snapshot(false);
+
+    for (const std::unique_ptr<Link>& link : m_links) {
+      std::fwrite(link->queueHistogram, sizeof(link->queueHistogram), 1, m_file);
+    }
+    std::fwrite("HLNK", 1, 4, m_file);
+    std::fclose(m_file);
+  }
+
+private:
+  struct Link {
+    LinkRecord record;
+    uint32_t queue;
+    Time lastChange;
+    double queueArea;      ///< packets * nanoseconds this period
+    uint64_t dequeuedBits; ///< this period
+    uint64_t dataRate;
+    uint64_t queueHistogram[QUEUE_BUCKETS];
+  };
+
+  LinkQueueTracer(const std::string& file, Time period)
+    : m_period(period)
+    , m_periodStart(Simulator::Now())
+  {
+    m_file = std::fopen(file.c_str(), "wb");
+    if (m_file == nullptr) {
+      NS_FATAL_ERROR("Cannot open link trace file " << file);
+    }
+
+    std::vector<std::string> names;
+    std::vector<uint32_t> limits;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      for (uint32_t i = 0; i < (*node)->GetNDevices(); ++i) {
+        Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>((*node)->GetDevice(i));
+        if (device == nullptr || device->GetQueue() == nullptr) {
+          continue;
+        }
+        names.push_back(GetNodeName(*node) + "->" + GetPeerName(device));
+        limits.push_back(GetQueueLimit(device->GetQueue()));
+        Attach(device);
+      }
+    }
+
+    uint32_t header[] = {0, VERSION, sizeof(LinkRecord), static_cast<uint32_t>(m_links.size())};
+    std::memcpy(header, "HLNK", 4);
+    std::fwrite(header, sizeof(header), 1, m_file);
+    for (size_t i = 0; i < m_links.size(); ++i) {
+      uint32_t nameLength = static_cast<uint32_t>(names[i].size());
+      std::fwrite(&limits[i], sizeof(uint32_t), 1, m_file);
+      std::fwrite(&m_links[i]->dataRate, sizeof(uint64_t), 1, m_file);
+      std::fwrite(&nameLength, sizeof(uint32_t), 1, m_file);
+      std::fwrite(names[i].data(), 1, names[i].size(), m_file);
+    }
+
+    m_event = Simulator::Schedule(m_period, &LinkQueueTracer::Snapshot, this, true);
+  }
+
+  static std::unique_ptr<LinkQueueTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<LinkQueueTracer> instance;
+    return instance;
+  }
+
+  void
+  Attach(Ptr<PointToPointNetDevice> device)
+  {
+    std::unique_ptr<Link> link(new Link());
+    std::memset(&link->record, 0, sizeof(link->record));
+    std::memset(link->queueHistogram, 0, sizeof(link->queueHistogram));
+    link->record.link = static_cast<uint32_t>(m_links.size());
+    link->queue = 0;
+    link->lastChange = Simulator::Now();
+    link->queueArea = 0;
+    link->dequeuedBits = 0;
+
+    DataRateValue rate;
+    device->GetAttribute("DataRate", rate);
+    link->dataRate = rate.Get().GetBitRate();
+
+    Ptr<Queue> queue = device->GetQueue();
+    queue->TraceConnectWithoutContext("Enqueue", MakeBoundCallback(&LinkQueueTracer::Enqueue, link.get()));
+    queue->TraceConnectWithoutContext("Dequeue", MakeBoundCallback(&LinkQueueTracer::Dequeue, link.get()));
+    queue->TraceConnectWithoutContext("Drop", MakeBoundCallback(&LinkQueueTracer::Drop, link.get()));
+
+    m_links.push_back(std::move(link));
+  }
+
+  static void
+  Enqueue(Link* link, Ptr<const Packet> packet)
+  {
+    ++link->queueHistogram[std::min(link->queue, QUEUE_BUCKETS - 1)];
+    SetQueue(link, link->queue + 1);
+    ++link->record.enqueues;
+  }
+
+  static void
+  Dequeue(Link* link, Ptr<const Packet> packet)
+  {
+    SetQueue(link, link->queue > 0 ? link->queue - 1 : 0);
+    ++link->record.dequeues;
+    link->dequeuedBits += packet->GetSize() * 8;
+  }
+
+  static void
+  Drop(Link* link, Ptr<const Packet> packet)
+  {
+    ++link->record.drops[Classify(packet)];
+  }
+
+  static void
+  SetQueue(Link* link, uint32_t queue)
+  {
+    Time now = Simulator::Now();
+    link->queueArea += static_cast<double>(link->queue) * (now - link->lastChange).GetNanoSeconds();
+    link->lastChange = now;
+    link->queue = queue;
+    link->record.maxQueue = std::max(link->record.maxQueue, queue);
+  }
+
+  static int
+  Classify(Ptr<const Packet> packet)
+  {
+    uint8_t head[3];
+    if (packet->CopyData(head, sizeof(head)) < sizeof(head)) {
+      return OTHER;
+    }
+    return head[2] == 0x05 ? INTEREST : head[2] == 0x06 ? DATA : OTHER;
+  }
+
+  /**
+   * \brief Write one record per link for the period that ends now (and schedule the next if @p next)
+   */
+  void
+  Snapshot(bool next)
+  {
+    Time now = Simulator::Now();
+    double length = static_cast<double>((now - m_periodStart).GetNanoSeconds());
+
+    for (const std::unique_ptr<Link>& link : m_links) {
+      SetQueue(link.get(), link->queue);
+
+      LinkRecord& record = link->record;
+      record.time = now.GetNanoSeconds();
+      record.meanQueue = length > 0 ? link->queueArea / length : 0;
+      record.utilization = length > 0 && link->dataRate > 0
+                             ? link->dequeuedBits / (link->dataRate * length / 1e9) : 0;
+      std::fwrite(&record, sizeof(record), 1, m_file);
+
+      uint32_t index = record.link;
+      std::memset(&record, 0, sizeof(record));
+      record.link = index;
+      record.maxQueue = link->queue;
+      link->queueArea = 0;
+      link->dequeuedBits = 0;
+    }
+
+    m_periodStart = now;
+    if (next) {
+      m_event = Simulator::Schedule(m_period, &LinkQueueTracer::Snapshot, this, true);
+    }
+  }
+
+  static uint32_t
+  GetQueueLimit(Ptr<Queue> queue)
+  {
+    TypeId::AttributeInformation info;
+    UintegerValue limit;
+    if (queue->GetInstanceTypeId().LookupAttributeByName("MaxPackets", &info)) {
+      queue->GetAttribute("MaxPackets", limit);
+      return static_cast<uint32_t>(limit.Get());
+    }
+    return 0;
+  }
+
+  static std::string
+  GetNodeName(Ptr<Node> node)
+  {
+    std::string name = Names::FindName(node);
+    return name.empty() ? std::to_string(node->GetId()) : name;
+  }
+
+  static std::string
+  GetPeerName(Ptr<PointToPointNetDevice> device)
+  {
+    Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel>(device->GetChannel());
+    if (channel == nullptr || channel->GetNDevices() < 2) {
+      return "?";
+    }
+    Ptr<NetDevice> peer = channel->GetDevice(0) == device ? channel->GetDevice(1) : channel->GetDevice(0);
+    return GetNodeName(peer->GetNode());
+  }
+
+private:
+  std::FILE* m_file;
+  Time m_period;
+  Time m_periodStart;
+  EventId m_event;
+  std::vector<std::unique_ptr<Link>> m_links;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_LINK_TRACER_HPP
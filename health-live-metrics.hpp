@@ -0,0 +1,321 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-live-metrics.hpp
+
+#ifndef HEALTH_LIVE_METRICS_HPP
+#define HEALTH_LIVE_METRICS_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "health-counting-scheduler.hpp"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Header of a LiveMetrics file, followed by `slots` LiveMetricsRecord
+ */
+struct LiveMetricsHeader {
+  char magic[4]; ///< "HLIV"
+  uint32_t version;
+  uint32_t slots;
+  uint32_t recordSize;
+  int32_t pid;
+  std::atomic<uint32_t> finished;  ///< 1 once the last record is written
+  std::atomic<uint64_t> published; ///< records written so far; record n is in slot n % slots
+};
+
+/**
+ * \brief One snapshot of the counters; the totals are cumulative since Install
+ */
+struct LiveMetricsRecord {
+  std::atomic<uint64_t> sequence; ///< 2n + 2 once record n is complete, odd while it is written
+  double wallTime;                ///< seconds since Install
+  double simTime;                 ///< seconds
+  uint64_t interests;             ///< interests sent by applications
+  uint64_t datas;                 ///< Data received by applications
+  uint64_t timeouts;              ///< retransmission timers that expired
+  uint64_t retransmissions;       ///< retransmissions of the interests answered so far
+  uint64_t drops;                 ///< packets dropped by point-to-point transmit queues
+  uint64_t events;                ///< events executed
+  double simPerWall;              ///< simulated seconds per wall second since the last record
+  double eventsPerSecond;         ///< events per wall second since the last record
+};
+
+/**
+ * \brief Publishes simulation counters to a shared-memory ring while the simulation runs
+ *
+ * The simulation thread only bumps plain single-writer counters from trace
+ * callbacks.  A background thread snapshots them once per wall-clock `interval`
+ * into a ring of LiveMetricsRecord in a memory-mapped file (put it under /dev/shm
+ * to keep it off the disk), so a stuck or slow run keeps reporting.  Each slot is
+ * a seqlock: readers copy a record and accept it only if its sequence number was
+ * the same, even, expected value before and after the copy.  Nothing blocks the
+ * simulation and there are no locks between processes.
+ *
+ * Simulated time and the event rate come from CountingScheduler, which Install
+ * puts in front of the `scheduler` type.  `tools/live-metrics-tail.cpp` follows
+ * the file from another terminal.
+ */
+class LiveMetrics {
+public:
+  static const uint32_t VERSION = 2;
+
+  /**
+   * \brief Start publishing to @p path
+   *
+   * @param scheduler type of the scheduler that CountingScheduler wraps, or empty
+   *                  if a CountingScheduler has already been selected
+   */
+  static void
+  Install(const std::string& path, Time interval = Seconds(1), uint32_t slots = 4096,
+          const std::string& scheduler = "ns3::MapScheduler")
+  {
+    if (!scheduler.empty()) {
+      ObjectFactory factory;
+      factory.SetTypeId("ns3::ndn::CountingScheduler");
+      factory.Set("Inner", StringValue(scheduler));
+      Simulator::SetScheduler(factory);
+    }
+
+    GetInstance().reset(new LiveMetrics(path, interval, slots));
+    LiveMetrics* metrics = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/TransmittedInterests",
+                                  MakeCallback(&LiveMetrics::TransmittedInterest, metrics));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/ReceivedDatas",
+                                  MakeCallback(&LiveMetrics::ReceivedData, metrics));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/TimedOutInterests",
+                                  MakeCallback(&LiveMetrics::TimedOutInterest, metrics));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/FirstInterestDataDelay",
+                                  MakeCallback(&LiveMetrics::FirstInterestDataDelay, metrics));
+    Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/TxQueue/Drop",
+                                  MakeCallback(&LiveMetrics::QueueDrop, metrics));
+
+    Simulator::ScheduleDestroy(&LiveMetrics::Destroy);
+  }
+
+  /**
+   * \brief Publish the final record, mark the file finished and stop the publisher
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~LiveMetrics()
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wakeup.notify_all();
+    m_publisher.join();
+
+    Publish();
+    m_header->finished.store(1, std::memory_order_release);
+    munmap(m_header, m_size);
+  }
+
+private:
+  LiveMetrics(const std::string& path, Time interval, uint32_t slots)
+    : m_interval(std::chrono::microseconds(interval.GetMicroSeconds()))
+    , m_interests(0)
+    , m_datas(0)
+    , m_timeouts(0)
+    , m_retransmissions(0)
+    , m_drops(0)
+    , m_stop(false)
+    , m_lastWall(0)
+    , m_lastSim(0)
+    , m_lastEvents(0)
+  {
+    m_size = sizeof(LiveMetricsHeader) + static_cast<size_t>(slots) * sizeof(LiveMetricsRecord);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+      NS_FATAL_ERROR("Cannot create live metrics file " << path);
+    }
+    void* base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      NS_FATAL_ERROR("Cannot map live metrics file " << path);
+    }
+
+    // the file is zero-filled, which is the initial state of every atomic in it
+    m_header = static_cast<LiveMetricsHeader*>(base);
+    m_records = reinterpret_cast<LiveMetricsRecord*>(m_header + 1);
+    m_header->version = VERSION;
+    m_header->slots = slots;
+    m_header->recordSize = sizeof(LiveMetricsRecord);
+    m_header->pid = getpid();
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_header->magic, "HLIV", 4);
+
+    m_start = std::chrono::steady_clock::now();
+    m_publisher = std::thread(&LiveMetrics::Run, this);
+  }
+
+  static std::unique_ptr<LiveMetrics>&
+  GetInstance()
+  {
+    static std::unique_ptr<LiveMetrics> instance;
+    return instance;
+  }
+
+  static void
+  Add(std::atomic<uint64_t>& counter, uint64_t value)
+  {
+    // only the simulation thread writes, so no read-modify-write is needed
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  void
+  TransmittedInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face)
+  {
+    Add(m_interests, 1);
+  }
+
+  void
+  ReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face)
+  {
+    Add(m_datas, 1);
+  }
+
+  void
+  TimedOutInterest(Ptr<App> app, uint32_t seqno)
+  {
+    Add(m_timeouts, 1);
+  }
+
+  /**
+   * \brief Count the retransmissions an answered interest needed
+   *
+   * The consumers already know them, so nothing has to remember outstanding names.
+   */
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+  {
+    if (retxCount > 1) {
+      Add(m_retransmissions, retxCount - 1);
+    }
+  }
+
+  void
+  QueueDrop(Ptr<const Packet> packet)
+  {
+    Add(m_drops, 1);
+  }
+
+  /**
+   * \brief Publisher thread: one record per interval until stopped
+   */
+  void
+  Run()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wakeup.wait_for(lock, m_interval, [this] { return m_stop; })) {
+      Publish();
+    }
+  }
+
+  void
+  Publish()
+  {
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    double sim = TimeStep(CountingScheduler::GetTimeStep().load(std::memory_order_relaxed)).GetSeconds();
+    uint64_t events = CountingScheduler::GetEventCount().load(std::memory_order_relaxed);
+    double elapsed = wall - m_lastWall;
+
+    uint64_t n = m_header->published.load(std::memory_order_relaxed);
+    LiveMetricsRecord& record = m_records[n % m_header->slots];
+    record.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.wallTime = wall;
+    record.simTime = sim;
+    record.interests = m_interests.load(std::memory_order_relaxed);
+    record.datas = m_datas.load(std::memory_order_relaxed);
+    record.timeouts = m_timeouts.load(std::memory_order_relaxed);
+    record.retransmissions = m_retransmissions.load(std::memory_order_relaxed);
+    record.drops = m_drops.load(std::memory_order_relaxed);
+    record.events = events;
+    record.simPerWall = elapsed > 0 ? (sim - m_lastSim) / elapsed : 0;
+    record.eventsPerSecond = elapsed > 0 ? (events - m_lastEvents) / elapsed : 0;
+
+    record.sequence.store(2 * n + 2, std::memory_order_release);
+    m_header->published.store(n + 1, std::memory_order_release);
+
+    m_lastWall = wall;
+    m_lastSim = sim;
+    m_lastEvents = events;
+  }
+
+private:
+  LiveMetricsHeader* m_header;
+  LiveMetricsRecord* m_records;
+  size_t m_size;
+  std::chrono::microseconds m_interval;
+  std::chrono::steady_clock::time_point m_start;
+
+  std::atomic<uint64_t> m_interests;
+  std::atomic<uint64_t> m_datas;
+  std::atomic<uint64_t> m_timeouts;
+  std::atomic<uint64_t> m_retransmissions;
+  std::atomic<uint64_t> m_drops;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_stop;
+  std::thread m_publisher;
+
+  // publisher thread only
+  double m_lastWall;
+  double m_lastSim;
+  uint64_t m_lastEvents;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_LIVE_METRICS_HPP
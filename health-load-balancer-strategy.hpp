@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-load-balancer-strategy.hpp
+
+#ifndef HEALTH_LOAD_BALANCER_STRATEGY_HPP
+#define HEALTH_LOAD_BALANCER_STRATEGY_HPP
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "face/face.hpp"
+#include "fw/strategy.hpp"
+
+#include "ns3/random-variable-stream.h"
+
+namespace nfd {
+namespace fw {
+
+/**
+ * \brief Per-prefix load information kept in the measurements table
+ *
+ * For every upstream face of the prefix the strategy keeps a smoothed RTT
+ * (RFC 6298 style, alpha = 1/8) and the number of interests currently
+ * pending on that face, i.e. of PIT out-records towards it.
+ */
+class HealthLoadInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9201;
+  }
+
+  struct FaceLoad {
+    FaceLoad()
+      : srtt(time::nanoseconds::zero())
+      , outstanding(0)
+    {
+    }
+
+    time::nanoseconds srtt;
+    uint32_t outstanding;
+  };
+
+  FaceLoad&
+  get(FaceId faceId)
+  {
+    return m_faces[faceId];
+  }
+
+  /**
+   * \brief Smallest smoothed RTT among faces that already have a sample
+   *
+   * Used as the optimistic estimate for faces that were never probed.
+   */
+  time::nanoseconds
+  getMinSrtt() const
+  {
+    time::nanoseconds minSrtt = time::nanoseconds::zero();
+    for (const auto& face : m_faces) {
+      if (face.second.srtt > time::nanoseconds::zero()
+          && (minSrtt == time::nanoseconds::zero() || face.second.srtt < minSrtt)) {
+        minSrtt = face.second.srtt;
+      }
+    }
+    return minSrtt;
+  }
+
+private:
+  std::unordered_map<FaceId, FaceLoad> m_faces;
+};
+
+/**
+ * \brief Upstream faces whose `outstanding` count includes one PIT entry
+ *
+ * Kept on the PIT entry, so the Data or the expiry that resolves it releases
+ * each face exactly once, however many Data still arrive for it.
+ */
+class HealthPendingInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9202;
+  }
+
+  std::vector<FaceId> faces;
+};
+
+/**
+ * \brief RTT-aware load balancer for prefixes served by several replica producers
+ *
+ * Every new interest goes to one upstream face chosen at random with a weight
+ * proportional to 1 / (srtt * (1 + outstanding)).  Faces that answer quickly and
+ * have few pending interests receive a proportionally larger share, while slower
+ * replicas are still probed so their estimates stay fresh.
+ *
+ * Install it on the replicated prefixes only, for example:
+ *
+ *     ndn::StrategyChoiceHelper::InstallAll<nfd::fw::HealthLoadBalancerStrategy>("/Pat1_2");
+ */
+class HealthLoadBalancerStrategy : public Strategy {
+public:
+  HealthLoadBalancerStrategy(Forwarder& forwarder, const Name& name = STRATEGY_NAME)
+    : Strategy(forwarder, name)
+    , m_random(ns3::CreateObject<ns3::UniformRandomVariable>())
+  {
+  }
+
+  virtual ~HealthLoadBalancerStrategy()
+  {
+  }
+
+  virtual void
+  afterReceiveInterest(const Face& inFace, const Interest& interest,
+                       shared_ptr<fib::Entry> fibEntry, shared_ptr<pit::Entry> pitEntry)
+  {
+    if (pitEntry->hasUnexpiredOutRecords()) {
+      // not a new Interest, don't forward
+      return;
+    }
+
+    shared_ptr<measurements::Entry> measurementsEntry = this->getMeasurements().get(*fibEntry);
+    shared_ptr<HealthLoadInfo> info = measurementsEntry->getOrCreateStrategyInfo<HealthLoadInfo>();
+    this->getMeasurements().extendLifetime(*measurementsEntry, MEASUREMENTS_LIFETIME);
+
+    time::nanoseconds defaultSrtt = info->getMinSrtt();
+    if (defaultSrtt == time::nanoseconds::zero()) {
+      defaultSrtt = INITIAL_SRTT;
+    }
+
+    const fib::NextHopList& nexthops = fibEntry->getNextHops();
+    std::vector<std::pair<shared_ptr<Face>, double>> candidates;
+    double totalWeight = 0.0;
+
+    for (const fib::NextHop& nexthop : nexthops) {
+      shared_ptr<Face> outFace = nexthop.getFace();
+      if (!pitEntry->canForwardTo(*outFace)) {
+        continue;
+      }
+
+      const HealthLoadInfo::FaceLoad& load = info->get(outFace->getId());
+      time::nanoseconds srtt = load.srtt > time::nanoseconds::zero() ? load.srtt : defaultSrtt;
+      double weight = 1.0 / (static_cast<double>(srtt.count()) * (1 + load.outstanding));
+
+      candidates.push_back(std::make_pair(outFace, weight));
+      totalWeight += weight;
+    }
+
+    if (candidates.empty()) {
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+
+    double point = m_random->GetValue(0.0, totalWeight);
+
+    shared_ptr<Face> selected = candidates.back().first;
+    for (const auto& candidate : candidates) {
+      if (point < candidate.second) {
+        selected = candidate.first;
+        break;
+      }
+      point -= candidate.second;
+    }
+
+    // a forward that renews an existing out-record is not another pending interest
+    std::vector<FaceId>& pending = pitEntry->getOrCreateStrategyInfo<HealthPendingInfo>()->faces;
+    if (std::find(pending.begin(), pending.end(), selected->getId()) == pending.end()) {
+      pending.push_back(selected->getId());
+      ++info->get(selected->getId()).outstanding;
+    }
+    this->sendInterest(pitEntry, selected);
+  }
+
+  virtual void
+  beforeSatisfyInterest(shared_ptr<pit::Entry> pitEntry, const Face& inFace, const Data& data)
+  {
+    shared_ptr<HealthLoadInfo> info = this->findLoadInfo(*pitEntry);
+    if (info == nullptr) {
+      return;
+    }
+
+    // the Data resolves the interest on every face it was sent to, but only the
+    // face it came from gives an RTT sample
+    releasePending(*pitEntry, *info);
+    time::steady_clock::TimePoint now = time::steady_clock::now();
+    for (const pit::OutRecord& outRecord : pitEntry->getOutRecords()) {
+      if (outRecord.getFace()->getId() == inFace.getId()) {
+        addRttSample(info->get(inFace.getId()), now - outRecord.getLastRenewed());
+      }
+    }
+  }
+
+  virtual void
+  beforeExpirePendingInterest(shared_ptr<pit::Entry> pitEntry)
+  {
+    shared_ptr<HealthLoadInfo> info = this->findLoadInfo(*pitEntry);
+    if (info == nullptr) {
+      return;
+    }
+
+    // an upstream that let the interest expire gets the time it had, the lifetime
+    // of the last forward, as an RTT sample, so the next interests drift towards
+    // other replicas
+    releasePending(*pitEntry, *info);
+    time::steady_clock::TimePoint now = time::steady_clock::now();
+    for (const pit::OutRecord& outRecord : pitEntry->getOutRecords()) {
+      addRttSample(info->get(outRecord.getFace()->getId()), now - outRecord.getLastRenewed());
+    }
+  }
+
+public:
+  static const Name STRATEGY_NAME;
+
+private:
+  /**
+   * \brief Take the faces @p pitEntry was counted on off their outstanding counts
+   */
+  static void
+  releasePending(pit::Entry& pitEntry, HealthLoadInfo& info)
+  {
+    shared_ptr<HealthPendingInfo> pending = pitEntry.getStrategyInfo<HealthPendingInfo>();
+    if (pending == nullptr) {
+      return;
+    }
+
+    for (FaceId faceId : pending->faces) {
+      HealthLoadInfo::FaceLoad& load = info.get(faceId);
+      if (load.outstanding > 0) {
+        --load.outstanding;
+      }
+    }
+    pending->faces.clear();
+  }
+
+  static void
+  addRttSample(HealthLoadInfo::FaceLoad& load, time::nanoseconds rtt)
+  {
+    rtt = std::min(rtt, MAX_SRTT);
+    if (load.srtt == time::nanoseconds::zero()) {
+      load.srtt = rtt;
+    }
+    else {
+      load.srtt = (load.srtt * 7 + rtt) / 8;
+    }
+  }
+
+  shared_ptr<HealthLoadInfo>
+  findLoadInfo(const pit::Entry& pitEntry)
+  {
+    shared_ptr<measurements::Entry> measurementsEntry =
+      this->getMeasurements().findLongestPrefixMatch(pitEntry.getName(),
+                                                     measurements::EntryWithStrategyInfo<HealthLoadInfo>());
+    if (measurementsEntry == nullptr) {
+      return nullptr;
+    }
+    return measurementsEntry->getStrategyInfo<HealthLoadInfo>();
+  }
+
+private:
+  // an ns-3 stream, so --RngRun changes the split
+  ns3::Ptr<ns3::UniformRandomVariable> m_random;
+
+  static const time::nanoseconds INITIAL_SRTT;
+  static const time::nanoseconds MAX_SRTT;
+  static const time::nanoseconds MEASUREMENTS_LIFETIME;
+};
+
+const Name HealthLoadBalancerStrategy::STRATEGY_NAME("ndn:/localhost/nfd/strategy/health-load-balancer");
+const time::nanoseconds HealthLoadBalancerStrategy::INITIAL_SRTT = time::milliseconds(10);
+const time::nanoseconds HealthLoadBalancerStrategy::MAX_SRTT = time::seconds(2);
+const time::nanoseconds HealthLoadBalancerStrategy::MEASUREMENTS_LIFETIME = time::seconds(16);
+
+} // namespace fw
+} // namespace nfd
+
+#endif // HEALTH_LOAD_BALANCER_STRATEGY_HPP
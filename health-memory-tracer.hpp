@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-memory-tracer.hpp
+
+#ifndef HEALTH_MEMORY_TRACER_HPP
+#define HEALTH_MEMORY_TRACER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <malloc.h>
+#include <unistd.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Entries and estimated bytes held by each subsystem of one node (or all nodes)
+ */
+struct MemoryUsage {
+  enum Subsystem { PIT, FIB, CS, NAME_TREE, MEASUREMENTS, QUEUES, N_SUBSYSTEMS };
+
+  uint64_t entries[N_SUBSYSTEMS] = {};
+  uint64_t bytes[N_SUBSYSTEMS] = {};
+
+  uint64_t
+  GetTotalBytes() const
+  {
+    uint64_t total = 0;
+    for (int i = 0; i < N_SUBSYSTEMS; ++i) {
+      total += bytes[i];
+    }
+    return total;
+  }
+
+  void
+  Add(const MemoryUsage& other)
+  {
+    for (int i = 0; i < N_SUBSYSTEMS; ++i) {
+      entries[i] += other.entries[i];
+      bytes[i] += other.bytes[i];
+    }
+  }
+
+  static const char*
+  GetName(int subsystem)
+  {
+    static const char* names[] = {"Pit", "Fib", "Cs", "NameTree", "Measurements", "Queues"};
+    return names[subsystem];
+  }
+};
+
+/**
+ * \brief Per-node memory accounting of the NDN tables and the link queues
+ *
+ * GetNodeUsage() and GetTotalUsage() can be called at any simulated time.  Entry
+ * counts are exact.  Bytes are exact for the queues (the queued packets) and for
+ * the Data held by the content store (wire size plus entry), and estimated as
+ * entries times the entry size for the other tables, since their entries mostly
+ * hold a shared name and a few records.  Process-wide, GetResidentBytes() and
+ * GetHeapBytes() give RSS and heap in use, which also cover application state and
+ * tracer buffers; the difference to GetTotalUsage() is what the tables do not
+ * explain.
+ *
+ * InstallAll() dumps the usage every `period` in long format, one line per node
+ * and subsystem, then `All` lines with the sums and the process-wide figures;
+ * Stop() adds the dump at the end of the run:
+ *
+ *     Time Node Subsystem Entries Bytes
+ */
+class MemoryTracer {
+public:
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(5))
+  {
+    GetInstance().reset(new MemoryTracer(file, period));
+    Simulator::ScheduleDestroy(&MemoryTracer::Destroy);
+  }
+
+  /**
+   * \brief Write the last dump, at the time the run stopped
+   *
+   * Call it once Simulator::Run() has returned.  Destroy() is too late: destroy
+   * events run in the order they were scheduled, so the nodes are gone by then.
+   */
+  static void
+  Stop()
+  {
+    if (GetInstance() != nullptr) {
+      Simulator::Cancel(GetInstance()->m_event);
+      GetInstance()->Dump(false);
+    }
+  }
+
+  /**
+   * \brief Close the file
+   */
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~MemoryTracer()
+  {
+    Simulator::Cancel(m_event);
+  }
+
+  static MemoryUsage
+  GetNodeUsage(Ptr<Node> node)
+  {
+    MemoryUsage usage;
+
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    if (l3 != nullptr) {
+      nfd::Forwarder& forwarder = *l3->getForwarder();
+
+      usage.entries[MemoryUsage::PIT] = forwarder.getPit().size();
+      usage.bytes[MemoryUsage::PIT] = usage.entries[MemoryUsage::PIT]
+                                      * (sizeof(nfd::pit::Entry) + sizeof(Interest));
+      usage.entries[MemoryUsage::FIB] = forwarder.getFib().size();
+      usage.bytes[MemoryUsage::FIB] = usage.entries[MemoryUsage::FIB] * sizeof(nfd::fib::Entry);
+      usage.entries[MemoryUsage::NAME_TREE] = forwarder.getNameTree().size();
+      usage.bytes[MemoryUsage::NAME_TREE] = usage.entries[MemoryUsage::NAME_TREE]
+                                            * sizeof(nfd::name_tree::Entry);
+      usage.entries[MemoryUsage::MEASUREMENTS] = forwarder.getMeasurements().size();
+      usage.bytes[MemoryUsage::MEASUREMENTS] = usage.entries[MemoryUsage::MEASUREMENTS]
+                                               * sizeof(nfd::measurements::Entry);
+
+      for (const nfd::cs::Entry& entry : forwarder.getCs()) {
+        ++usage.entries[MemoryUsage::CS];
+        usage.bytes[MemoryUsage::CS] += sizeof(entry) + entry.getData().wireEncode().size();
+      }
+    }
+
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i) {
+      Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>(node->GetDevice(i));
+      if (device != nullptr && device->GetQueue() != nullptr) {
+        usage.entries[MemoryUsage::QUEUES] += device->GetQueue()->GetNPackets();
+        usage.bytes[MemoryUsage::QUEUES] += device->GetQueue()->GetNBytes();
+      }
+    }
+
+    return usage;
+  }
+
+  static MemoryUsage
+  GetTotalUsage()
+  {
+    MemoryUsage usage;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      usage.Add(GetNodeUsage(*node));
+    }
+    return usage;
+  }
+
+  /**
+   * \brief Resident set size of the process, from /proc/self/statm (0 if unavailable)
+   */
+  static uint64_t
+  GetResidentBytes()
+  {
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+      return 0;
+    }
+    if (std::fscanf(statm, "%lu %lu", &size, &resident) != 2) {
+      resident = 0;
+    }
+    std::fclose(statm);
+    return static_cast<uint64_t>(resident) * sysconf(_SC_PAGESIZE);
+  }
+
+  /**
+   * \brief Bytes the allocator has handed out and not got back
+   */
+  static uint64_t
+  GetHeapBytes()
+  {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    struct mallinfo info = mallinfo();
+    return static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd);
+#endif
+  }
+
+private:
+  MemoryTracer(const std::string& file, Time period)
+    : m_os(file.c_str(), std::ios_base::out | std::ios_base::trunc)
+    , m_period(period)
+  {
+    if (!m_os.is_open()) {
+      NS_FATAL_ERROR("Cannot open memory trace file " << file);
+    }
+
+    m_os << "Time\tNode\tSubsystem\tEntries\tBytes\n";
+    m_event = Simulator::ScheduleNow(&MemoryTracer::Dump, this, true);
+  }
+
+  static std::unique_ptr<MemoryTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<MemoryTracer> instance;
+    return instance;
+  }
+
+  void
+  Dump(bool next)
+  {
+    double now = Simulator::Now().ToDouble(Time::S);
+
+    MemoryUsage total;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      MemoryUsage usage = GetNodeUsage(*node);
+      std::string name = Names::FindName(*node);
+      Print(now, name.empty() ? std::to_string((*node)->GetId()) : name, usage);
+      total.Add(usage);
+    }
+    Print(now, "All", total);
+    m_os << now << "\tAll\tTables\t-\t" << total.GetTotalBytes() << "\n"
+         << now << "\tAll\tHeap\t-\t" << GetHeapBytes() << "\n"
+         << now << "\tAll\tRss\t-\t" << GetResidentBytes() << "\n";
+    m_os.flush();
+
+    if (next) {
+      m_event = Simulator::Schedule(m_period, &MemoryTracer::Dump, this, true);
+    }
+  }
+
+  void
+  Print(double now, const std::string& node, const MemoryUsage& usage)
+  {
+    for (int i = 0; i < MemoryUsage::N_SUBSYSTEMS; ++i) {
+      m_os << now << "\t" << node << "\t" << MemoryUsage::GetName(i) << "\t" << usage.entries[i] << "\t"
+           << usage.bytes[i] << "\n";
+    }
+  }
+
+private:
+  std::ofstream m_os;
+  Time m_period;
+  EventId m_event;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_MEMORY_TRACER_HPP
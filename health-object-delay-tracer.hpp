@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-object-delay-tracer.hpp
+
+#ifndef HEALTH_OBJECT_DELAY_TRACER_HPP
+#define HEALTH_OBJECT_DELAY_TRACER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/fatal-error.h"
+#include "ns3/names.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Writes the object transfers of ConsumerHealthObject, one line per object
+ *
+ * Object transfer times span a whole manifest and segment exchange, so they are
+ * kept out of FirstInterestDataDelay and the per-packet delay tracers.  Each
+ * `ObjectDelay` and `DroppedObject` becomes one line:
+ *
+ *     Time Node AppId SeqNo Type DelayS ObjectSize Segments RetxCount
+ *
+ * where Type is `Complete` or `Dropped`; dropped objects have no delay or sizes.
+ */
+class ObjectDelayTracer {
+public:
+  static void
+  InstallAll(const std::string& file)
+  {
+    GetInstance().reset(new ObjectDelayTracer(file));
+    ObjectDelayTracer* tracer = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/ObjectDelay",
+                                  MakeCallback(&ObjectDelayTracer::ObjectDelay, tracer));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/DroppedObject",
+                                  MakeCallback(&ObjectDelayTracer::DroppedObject, tracer));
+
+    Simulator::ScheduleDestroy(&ObjectDelayTracer::Destroy);
+  }
+
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+private:
+  explicit ObjectDelayTracer(const std::string& file)
+    : m_os(file.c_str(), std::ios_base::out | std::ios_base::trunc)
+  {
+    if (!m_os.is_open()) {
+      NS_FATAL_ERROR("Cannot open object delay trace file " << file);
+    }
+
+    m_os << "Time\tNode\tAppId\tSeqNo\tType\tDelayS\tObjectSize\tSegments\tRetxCount\n";
+  }
+
+  static std::unique_ptr<ObjectDelayTracer>&
+  GetInstance()
+  {
+    static std::unique_ptr<ObjectDelayTracer> instance;
+    return instance;
+  }
+
+  void
+  ObjectDelay(Ptr<App> app, uint32_t seqno, Time delay, uint64_t objectSize, uint32_t segmentCount,
+              uint32_t retxCount)
+  {
+    PrintPrefix(app, seqno);
+    m_os << "Complete\t" << delay.ToDouble(Time::S) << "\t" << objectSize << "\t" << segmentCount << "\t"
+         << retxCount << "\n";
+  }
+
+  void
+  DroppedObject(Ptr<App> app, uint32_t seqno, uint32_t retxCount)
+  {
+    PrintPrefix(app, seqno);
+    m_os << "Dropped\t-\t-\t-\t" << retxCount << "\n";
+  }
+
+  void
+  PrintPrefix(Ptr<App> app, uint32_t seqno)
+  {
+    std::string node = Names::FindName(app->GetNode());
+    m_os << Simulator::Now().ToDouble(Time::S) << "\t"
+         << (node.empty() ? std::to_string(app->GetNode()->GetId()) : node) << "\t" << app->GetId() << "\t"
+         << seqno << "\t";
+  }
+
+private:
+  std::ofstream m_os;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_OBJECT_DELAY_TRACER_HPP
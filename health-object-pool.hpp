@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-object-pool.hpp
+
+#ifndef HEALTH_OBJECT_POOL_HPP
+#define HEALTH_OBJECT_POOL_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Free list of fixed-size blocks carved out of slabs
+ *
+ * Blocks of one size are handed out and taken back with two pointer moves; the
+ * slabs are only returned to the heap in bulk by Release(), and only once every
+ * block has come back.  Not thread-safe: pools serve the simulation thread.
+ */
+class BlockPool {
+public:
+  enum : size_t { SLAB_BLOCKS = 256 };
+
+  explicit BlockPool(size_t size)
+    : m_size((std::max(size, sizeof(void*)) + alignof(std::max_align_t) - 1)
+             / alignof(std::max_align_t) * alignof(std::max_align_t))
+    , m_free(nullptr)
+    , m_live(0)
+  {
+  }
+
+  /**
+   * \brief Pool for blocks of @p Size bytes; never destroyed, so blocks freed by
+   *        other static objects at exit still find it
+   */
+  template<size_t Size>
+  static BlockPool&
+  Get()
+  {
+    static BlockPool* pool = Register(new BlockPool(Size));
+    return *pool;
+  }
+
+  void*
+  Allocate()
+  {
+    if (m_free == nullptr) {
+      Grow();
+    }
+    void* block = m_free;
+    m_free = *static_cast<void**>(block);
+    ++m_live;
+    return block;
+  }
+
+  void
+  Deallocate(void* block)
+  {
+    *static_cast<void**>(block) = m_free;
+    m_free = block;
+    --m_live;
+  }
+
+  /**
+   * \brief Return the slabs to the heap if no block is in use
+   */
+  void
+  Release()
+  {
+    if (m_live > 0) {
+      return;
+    }
+    for (void* slab : m_slabs) {
+      ::operator delete(slab);
+    }
+    m_slabs.clear();
+    m_free = nullptr;
+  }
+
+  /**
+   * \brief Release() every pool; runs when the simulator is destroyed
+   */
+  static void
+  ReleaseAll()
+  {
+    for (BlockPool* pool : GetPools()) {
+      pool->Release();
+    }
+    IsReleaseScheduled() = false;
+  }
+
+private:
+  static BlockPool*
+  Register(BlockPool* pool)
+  {
+    GetPools().push_back(pool);
+    return pool;
+  }
+
+  static std::vector<BlockPool*>&
+  GetPools()
+  {
+    static std::vector<BlockPool*>* pools = new std::vector<BlockPool*>();
+    return *pools;
+  }
+
+  static bool&
+  IsReleaseScheduled()
+  {
+    static bool scheduled = false;
+    return scheduled;
+  }
+
+  void
+  Grow()
+  {
+    char* slab = static_cast<char*>(::operator new(m_size * SLAB_BLOCKS));
+    m_slabs.push_back(slab);
+    for (size_t i = SLAB_BLOCKS; i > 0; --i) {
+      void* block = slab + (i - 1) * m_size;
+      *static_cast<void**>(block) = m_free;
+      m_free = block;
+    }
+
+    if (!IsReleaseScheduled()) {
+      IsReleaseScheduled() = true;
+      Simulator::ScheduleDestroy(&BlockPool::ReleaseAll);
+    }
+  }
+
+private:
+  size_t m_size;
+  void* m_free;
+  size_t m_live;
+  std::vector<void*> m_slabs;
+};
+
+/**
+ * \brief Allocator that serves single objects from the BlockPool of their size
+ *
+ * Meant for std::allocate_shared, which rebinds it to its control block so the
+ * object and its reference counts come out of one pooled block.
+ */
+template<typename T>
+class PoolAllocator {
+public:
+  typedef T value_type;
+
+  PoolAllocator() = default;
+
+  template<typename U>
+  PoolAllocator(const PoolAllocator<U>&)
+  {
+  }
+
+  T*
+  allocate(size_t n)
+  {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(BlockPool::Get<sizeof(T)>().Allocate());
+  }
+
+  void
+  deallocate(T* p, size_t n)
+  {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    BlockPool::Get<sizeof(T)>().Deallocate(p);
+  }
+
+  template<typename U>
+  bool
+  operator==(const PoolAllocator<U>&) const
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool
+  operator!=(const PoolAllocator<U>&) const
+  {
+    return false;
+  }
+};
+
+/**
+ * \brief make_shared from the object pools, e.g. MakePooled<Interest>()
+ */
+template<typename T, typename... Args>
+shared_ptr<T>
+MakePooled(Args&&... args)
+{
+  return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_OBJECT_POOL_HPP
@@ -0,0 +1,641 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-producer-ext.hpp
+
+#ifndef HEALTH_PRODUCER_EXT_HPP
+#define HEALTH_PRODUCER_EXT_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "ns3/ndnSIM/helper/ndn-fib-helper.hpp"
+
+#include "health-object-pool.hpp"
+#include "health-sample-store.hpp"
+
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * \brief HealthProducer with pre-encoded Data templates
+ *
+ * Answers every interest under `Prefix` with a `PayloadSize` Data packet, like
+ * HealthProducer.  Names follow one scheme,
+ *
+ *     /<patient>/<device>/<seq>[/<segment>]
+ *
+ * with `<seq>` a sequence-number component: a producer for one device has the
+ * `Prefix` `/<patient>/<device>`, and ConsumerHealthMulti and ConsumerHealthObject
+ * are given such device prefixes and append the rest.  The content starts with a
+ * small header:
+ *
+ *     offset 0   DataType    (1 byte)
+ *     offset 1   DiseaseRank (1 byte)
+ *     offset 8   generation time in simulated nanoseconds (8 bytes, big endian)
+ *
+ * With `UseTemplate` (default) everything after the Name (MetaInfo, Content,
+ * SignatureInfo, SignatureValue) is encoded once when the application starts.
+ * A reply then only writes the outer TLV header, copies the interest's Name
+ * wire and the template into a pooled buffer, and patches the timestamp in place.
+ * Pooled buffers are reused once nothing else (content store, queues) holds them.
+ * With `UseTemplate` false every reply is built and encoded from scratch.
+ *
+ * `SigningMode` selects what signing costs:
+ *
+ * - `full`: every reply is signed with the key of a `Prefix` identity in an
+ *   in-memory KeyChain (templates are not used, since the signature covers the
+ *   name); the stack's KeyChain would only produce dummy signatures;
+ * - `cached`: the template is signed once with that key and every reply reuses
+ *   the signature;
+ * - `null`: fake signature (type 255, value `Signature`), no crypto at all.
+ *
+ * Independently of the mode, `SigningDelay` models the device CPU time spent on
+ * signing: replies leave the producer one after another, each `SigningDelay`
+ * after the previous one finished, so a busy device queues its replies.
+ *
+ * With `SampleFile` set, the payload after the header is real sample data rather
+ * than zeros: the record of device `DeviceIndex` whose index is the sequence number
+ * of the requested name, taken from a memory-mapped HealthSampleStore file
+ * (`PayloadSize` is then ignored).  The record is copied once, straight from the
+ * mapping into the outgoing wire buffer; there is no per-packet file I/O.
+ *
+ * With `Devices` set, one application emulates several devices of a patient
+ * behind a single face: `Prefix` is the patient prefix (e.g. `/Pat1`) and
+ * `Devices` lists `name:DataType:DiseaseRank` entries (e.g.
+ * `"Dev1:2:1 Dev2:2:3 Dev3:4:2"`) for the `<device>` component that follows it.
+ * An interest for `/Pat1/Dev2/<seq>` is answered with Dev2's type and rank, and
+ * with sample device `DeviceIndex + 1`; interests for devices that are not listed
+ * stay unanswered.
+ *
+ * With `ObjectSize` set, devices of type `BulkDataType` (imaging, long waveform
+ * windows) publish every reading as a segmented object instead of one packet.
+ * An interest for `/<patient>/<device>/<seq>` returns the object's manifest,
+ * whose content is the usual header followed by
+ *
+ *     offset 16  object size in bytes   (8 bytes, big endian)
+ *     offset 24  number of segments     (4 bytes, big endian)
+ *     offset 28  segment payload size   (4 bytes, big endian)
+ *
+ * and `/<patient>/<device>/<seq>/<segment>` returns one `PayloadSize` segment of
+ * it (the last one shorter).  Segments are encoded fresh but share one zero-filled
+ * content buffer, and pass through the same signing mode and `SigningDelay` as
+ * readings.
+ * ConsumerHealthObject fetches such objects.
+ */
+class HealthProducerExt : public App {
+public:
+  static const size_t CONTENT_HEADER_SIZE = 16;
+  static const size_t TIMESTAMP_OFFSET = 8;
+  static const size_t MANIFEST_SIZE = 32;
+
+  enum SigningMode { SIGN_FULL, SIGN_CACHED, SIGN_NULL };
+
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::ndn::HealthProducerExt")
+        .SetGroupName("Ndn")
+        .SetParent<App>()
+        .AddConstructor<HealthProducerExt>()
+        .AddAttribute("Prefix", "Prefix, for which producer has the data", StringValue("/"),
+                      MakeNameAccessor(&HealthProducerExt::m_prefix), MakeNameChecker())
+        .AddAttribute("PayloadSize", "Virtual payload size for Content packets", UintegerValue(1024),
+                      MakeUintegerAccessor(&HealthProducerExt::m_virtualPayloadSize),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("Freshness", "Freshness of data packets, if 0, then unlimited freshness",
+                      TimeValue(Seconds(0)), MakeTimeAccessor(&HealthProducerExt::m_freshness),
+                      MakeTimeChecker())
+        .AddAttribute("DataType", "Type of the reading produced by the device", UintegerValue(2),
+                      MakeUintegerAccessor(&HealthProducerExt::m_dataType),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("DiseaseRank", "Acuity of the patient wearing the device", UintegerValue(1),
+                      MakeUintegerAccessor(&HealthProducerExt::m_diseaseRank),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("Signature",
+                      "Fake signature, 0 valid signature (default), other values application-specific",
+                      UintegerValue(0), MakeUintegerAccessor(&HealthProducerExt::m_signature),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("SigningMode", "Signing cost model: full, cached or null",
+                      EnumValue(SIGN_NULL), MakeEnumAccessor(&HealthProducerExt::m_signingMode),
+                      MakeEnumChecker(SIGN_FULL, "full", SIGN_CACHED, "cached", SIGN_NULL, "null"))
+        .AddAttribute("SigningDelay", "Simulated device CPU time to sign one Data packet",
+                      TimeValue(Seconds(0)), MakeTimeAccessor(&HealthProducerExt::m_signingDelay),
+                      MakeTimeChecker())
+        .AddAttribute("SampleFile", "Memory-mapped file with per-device sample records (empty: dummy payload)",
+                      StringValue(""), MakeStringAccessor(&HealthProducerExt::m_sampleFile),
+                      MakeStringChecker())
+        .AddAttribute("DeviceIndex", "Device whose records are served from SampleFile",
+                      UintegerValue(0), MakeUintegerAccessor(&HealthProducerExt::m_deviceIndex),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("Devices", "Space-separated name:DataType:DiseaseRank entries of emulated devices",
+                      StringValue(""), MakeStringAccessor(&HealthProducerExt::m_deviceList),
+                      MakeStringChecker())
+        .AddAttribute("ObjectSize", "Size of the objects published by bulk devices (0: one Data per reading)",
+                      UintegerValue(0), MakeUintegerAccessor(&HealthProducerExt::m_objectSize),
+                      MakeUintegerChecker<uint64_t>())
+        .AddAttribute("BulkDataType", "DataType of the devices that publish segmented objects",
+                      UintegerValue(4), MakeUintegerAccessor(&HealthProducerExt::m_bulkDataType),
+                      MakeUintegerChecker<uint8_t>())
+        .AddAttribute("UseTemplate", "Patch a pre-encoded Data template instead of encoding every reply",
+                      BooleanValue(true), MakeBooleanAccessor(&HealthProducerExt::m_useTemplate),
+                      MakeBooleanChecker())
+        .AddAttribute("BufferPoolSize", "Maximum number of wire buffers kept for reuse",
+                      UintegerValue(64), MakeUintegerAccessor(&HealthProducerExt::m_poolSize),
+                      MakeUintegerChecker<uint32_t>(1));
+
+    return tid;
+  }
+
+  HealthProducerExt()
+    : m_virtualPayloadSize(1024)
+    , m_dataType(2)
+    , m_diseaseRank(1)
+    , m_signature(0)
+    , m_signingMode(SIGN_NULL)
+    , m_deviceIndex(0)
+    , m_objectSize(0)
+    , m_bulkDataType(4)
+    , m_useTemplate(true)
+    , m_poolSize(64)
+    , m_poolNext(0)
+    , m_contentOffset(0)
+  {
+  }
+
+  virtual void
+  OnInterest(shared_ptr<const Interest> interest)
+  {
+    App::OnInterest(interest); // tracing inside
+
+    if (!m_active)
+      return;
+
+    const Device* device = FindDevice(interest->getName());
+    if (device == nullptr)
+      return;
+
+    shared_ptr<Data> data;
+    if (IsBulk(*device)) {
+      data = MakeObjectPart(interest->getName(), *device);
+      if (data == nullptr)
+        return;
+      Sign(*data);
+    }
+    else if (m_useTemplate && m_signingMode != SIGN_FULL) {
+      data = MakeFromTemplate(interest->getName(), *device);
+    }
+    else {
+      data = MakeFresh(interest->getName(), *device);
+      Sign(*data);
+    }
+
+    if (m_signingDelay.IsZero()) {
+      SendData(data);
+      return;
+    }
+
+    // replies are signed one at a time by the device CPU
+    Time start = std::max(Simulator::Now(), m_cpuBusyUntil);
+    m_cpuBusyUntil = start + m_signingDelay;
+    Simulator::Schedule(m_cpuBusyUntil - Simulator::Now(), &HealthProducerExt::SendData, this, data);
+  }
+
+protected:
+  struct Device {
+    name::Component name;
+    uint8_t dataType;
+    uint8_t diseaseRank;
+    uint32_t sampleIndex;
+  };
+
+  virtual void
+  StartApplication()
+  {
+    App::StartApplication();
+    FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
+
+    m_cpuBusyUntil = Simulator::Now();
+    ParseDevices();
+
+    if (!m_sampleFile.empty()) {
+      m_samples = HealthSampleStore::Open(m_sampleFile);
+    }
+
+    if (m_signingMode != SIGN_NULL) {
+      m_signingInfo = ::ndn::security::signingByIdentity(GetKeyChain().createIdentity(m_prefix));
+    }
+
+    if (m_signingMode == SIGN_CACHED) {
+      shared_ptr<Data> prototype = MakeFresh(m_prefix, m_devices.front());
+      GetKeyChain().sign(*prototype, m_signingInfo);
+      m_cachedSignature = prototype->getSignature();
+    }
+
+    if (m_useTemplate && m_signingMode != SIGN_FULL) {
+      BuildTemplate();
+    }
+
+    if (m_objectSize > 0) {
+      m_segmentContent = make_shared< ::ndn::Buffer>(GetSegmentSize());
+    }
+  }
+
+  virtual void
+  StopApplication()
+  {
+    m_pool.clear();
+    m_samples.reset();
+    m_segmentContent.reset();
+    App::StopApplication();
+  }
+
+  void
+  ParseDevices()
+  {
+    m_devices.clear();
+
+    if (m_deviceList.empty()) {
+      Device self = {name::Component(), m_dataType, m_diseaseRank, m_deviceIndex};
+      m_devices.push_back(self);
+      return;
+    }
+
+    std::istringstream entries(m_deviceList);
+    std::string entry;
+    while (entries >> entry) {
+      size_t first = entry.find(':');
+      size_t second = entry.find(':', first == std::string::npos ? first : first + 1);
+      if (second == std::string::npos) {
+        NS_FATAL_ERROR("Device entry " << entry << " is not name:DataType:DiseaseRank");
+      }
+
+      Device device;
+      device.name = name::Component(entry.substr(0, first));
+      device.dataType = static_cast<uint8_t>(std::stoul(entry.substr(first + 1, second - first - 1)));
+      device.diseaseRank = static_cast<uint8_t>(std::stoul(entry.substr(second + 1)));
+      device.sampleIndex = m_deviceIndex + static_cast<uint32_t>(m_devices.size());
+      m_devices.push_back(device);
+    }
+
+    // the template and the cached signature are built from the first device
+    if (m_devices.empty()) {
+      NS_FATAL_ERROR("Devices \"" << m_deviceList << "\" lists no device");
+    }
+  }
+
+  /**
+   * \brief Emulated device that @p dataName belongs to, or nullptr if there is none
+   */
+  const Device*
+  FindDevice(const Name& dataName) const
+  {
+    if (m_deviceList.empty()) {
+      return &m_devices.front();
+    }
+
+    if (dataName.size() <= m_prefix.size()) {
+      return nullptr;
+    }
+
+    const name::Component& component = dataName.get(m_prefix.size());
+    for (const Device& device : m_devices) {
+      if (device.name == component) {
+        return &device;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * \brief KeyChain holding the producers' identities
+   *
+   * StackHelper::getKeyChain() is a dummy that signs without any crypto.
+   */
+  static ::ndn::KeyChain&
+  GetKeyChain()
+  {
+    static ::ndn::KeyChain keyChain("pib-memory:", "tpm-memory:");
+    return keyChain;
+  }
+
+  /**
+   * \brief Apply the signing mode to a Data built by MakeFresh() or MakeObjectPart(),
+   *        which encodes it
+   */
+  void
+  Sign(Data& data) const
+  {
+    if (m_signingMode == SIGN_FULL) {
+      GetKeyChain().sign(data, m_signingInfo);
+      return;
+    }
+
+    if (m_signingMode == SIGN_CACHED) {
+      data.setSignature(m_cachedSignature);
+    }
+    else {
+      Signature signature;
+      SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+      signature.setInfo(signatureInfo);
+      signature.setValue(::ndn::nonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+      data.setSignature(signature);
+    }
+    data.wireEncode();
+  }
+
+  void
+  SendData(shared_ptr<Data> data)
+  {
+    if (!m_active)
+      return;
+
+    m_transmittedDatas(data, this, m_face);
+    m_face->onReceiveData(*data);
+  }
+
+  /**
+   * \brief Fill @p content with the reading header and the dummy payload
+   */
+  void
+  FillContent(uint8_t* content, size_t size, const Device& device) const
+  {
+    std::memset(content, 0, size);
+    content[0] = device.dataType;
+    content[1] = device.diseaseRank;
+    WriteTimestamp(content + TIMESTAMP_OFFSET);
+  }
+
+  static void
+  WriteTimestamp(uint8_t* pos)
+  {
+    uint64_t now = static_cast<uint64_t>(Simulator::Now().GetNanoSeconds());
+    for (int i = 7; i >= 0; --i) {
+      pos[i] = static_cast<uint8_t>(now & 0xFF);
+      now >>= 8;
+    }
+  }
+
+  size_t
+  GetContentSize() const
+  {
+    if (m_samples != nullptr) {
+      return CONTENT_HEADER_SIZE + m_samples->GetRecordSize();
+    }
+    return std::max<size_t>(m_virtualPayloadSize, CONTENT_HEADER_SIZE);
+  }
+
+  /**
+   * \brief Copy the sample record for @p dataName, if any, to @p pos
+   */
+  void
+  CopySamples(const Name& dataName, const Device& device, uint8_t* pos) const
+  {
+    if (m_samples == nullptr) {
+      return;
+    }
+
+    uint64_t index = 0;
+    if (!dataName.empty() && dataName.at(-1).isSequenceNumber()) {
+      index = dataName.at(-1).toSequenceNumber();
+    }
+    std::memcpy(pos, m_samples->GetRecord(device.sampleIndex, index), m_samples->GetRecordSize());
+  }
+
+  /**
+   * \brief Reading built from scratch, left unsigned and unencoded for Sign()
+   */
+  shared_ptr<Data>
+  MakeFresh(const Name& dataName, const Device& device) const
+  {
+    auto data = MakePooled<Data>();
+    data->setName(dataName);
+    data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+
+    auto content = MakePooled< ::ndn::Buffer>(GetContentSize());
+    FillContent(&(*content)[0], content->size(), device);
+    CopySamples(dataName, device, &(*content)[CONTENT_HEADER_SIZE]);
+    data->setContent(content);
+
+    return data;
+  }
+
+  bool
+  IsBulk(const Device& device) const
+  {
+    return m_objectSize > 0 && device.dataType == m_bulkDataType;
+  }
+
+  size_t
+  GetSegmentSize() const
+  {
+    return std::max<uint32_t>(m_virtualPayloadSize, 1);
+  }
+
+  /**
+   * \brief Manifest or segment of a bulk device's object, nullptr for a segment past the end
+   *
+   * Like MakeFresh(), the part is left for Sign().
+   */
+  shared_ptr<Data>
+  MakeObjectPart(const Name& dataName, const Device& device) const
+  {
+    uint64_t segmentSize = GetSegmentSize();
+    uint64_t segmentCount = (m_objectSize + segmentSize - 1) / segmentSize;
+
+    auto data = MakePooled<Data>();
+    data->setName(dataName);
+    data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+
+    if (!dataName.empty() && dataName.at(-1).isSegment()) {
+      uint64_t segment = dataName.at(-1).toSegment();
+      if (segment >= segmentCount) {
+        return nullptr;
+      }
+
+      if (segment + 1 < segmentCount || m_objectSize % segmentSize == 0) {
+        data->setContent(m_segmentContent);
+      }
+      else {
+        data->setContent(&(*m_segmentContent)[0], m_objectSize % segmentSize);
+      }
+    }
+    else {
+      auto content = MakePooled< ::ndn::Buffer>(MANIFEST_SIZE);
+      FillContent(&(*content)[0], content->size(), device);
+      WriteBigEndian(&(*content)[16], m_objectSize, 8);
+      WriteBigEndian(&(*content)[24], segmentCount, 4);
+      WriteBigEndian(&(*content)[28], segmentSize, 4);
+      data->setContent(content);
+    }
+
+    return data;
+  }
+
+  static void
+  WriteBigEndian(uint8_t* pos, uint64_t value, size_t size)
+  {
+    for (size_t i = size; i > 0; --i) {
+      pos[i - 1] = static_cast<uint8_t>(value & 0xFF);
+      value >>= 8;
+    }
+  }
+
+  /**
+   * \brief Encode a prototype Data and keep everything that follows its Name
+   */
+  void
+  BuildTemplate()
+  {
+    shared_ptr<Data> prototype = MakeFresh(m_prefix, m_devices.front());
+    Sign(*prototype);
+    const Block& wire = prototype->wireEncode();
+    wire.parse();
+
+    const Block& name = wire.get(::ndn::tlv::Name);
+    const Block& content = wire.get(::ndn::tlv::Content);
+
+    m_template.assign(name.end(), wire.value_end());
+    m_contentOffset = content.value_begin() - name.end();
+    m_pool.clear();
+    m_poolNext = 0;
+  }
+
+  shared_ptr<Data>
+  MakeFromTemplate(const Name& dataName, const Device& device)
+  {
+    const Block& name = dataName.wireEncode();
+    size_t valueLength = name.size() + m_template.size();
+    size_t length = VarNumberSize(::ndn::tlv::Data) + VarNumberSize(valueLength) + valueLength;
+
+    shared_ptr< ::ndn::Buffer> buffer = AcquireBuffer(length);
+    uint8_t* pos = &(*buffer)[0];
+    pos = WriteVarNumber(pos, ::ndn::tlv::Data);
+    pos = WriteVarNumber(pos, valueLength);
+    pos = std::copy(name.begin(), name.end(), pos);
+    std::memcpy(pos, &m_template[0], m_template.size());
+    uint8_t* content = pos + m_contentOffset;
+    content[0] = device.dataType;
+    content[1] = device.diseaseRank;
+    WriteTimestamp(content + TIMESTAMP_OFFSET);
+    CopySamples(dataName, device, content + CONTENT_HEADER_SIZE);
+
+    return MakePooled<Data>(Block(buffer));
+  }
+
+  /**
+   * \brief Wire buffer of @p length bytes, taken from the pool when one is free
+   */
+  shared_ptr< ::ndn::Buffer>
+  AcquireBuffer(size_t length)
+  {
+    for (size_t i = 0; i < m_pool.size(); ++i) {
+      shared_ptr< ::ndn::Buffer>& candidate = m_pool[m_poolNext];
+      m_poolNext = (m_poolNext + 1) % m_pool.size();
+
+      if (candidate.use_count() == 1) {
+        candidate->resize(length);
+        return candidate;
+      }
+    }
+
+    auto buffer = make_shared< ::ndn::Buffer>(length);
+    if (m_pool.size() < m_poolSize) {
+      m_pool.push_back(buffer);
+    }
+    return buffer;
+  }
+
+  static size_t
+  VarNumberSize(uint64_t number)
+  {
+    return number < 253 ? 1 : number <= 0xFFFF ? 3 : number <= 0xFFFFFFFF ? 5 : 9;
+  }
+
+  static uint8_t*
+  WriteVarNumber(uint8_t* pos, uint64_t number)
+  {
+    size_t size = VarNumberSize(number);
+    if (size == 1) {
+      *pos = static_cast<uint8_t>(number);
+      return pos + 1;
+    }
+
+    *pos = size == 3 ? 253 : size == 5 ? 254 : 255;
+    for (size_t i = size - 1; i >= 1; --i) {
+      pos[i] = static_cast<uint8_t>(number & 0xFF);
+      number >>= 8;
+    }
+    return pos + size;
+  }
+
+protected:
+  Name m_prefix;
+  uint32_t m_virtualPayloadSize;
+  Time m_freshness;
+  uint8_t m_dataType;
+  uint8_t m_diseaseRank;
+  uint32_t m_signature;
+  SigningMode m_signingMode;
+  Time m_signingDelay;
+  std::string m_sampleFile;
+  uint32_t m_deviceIndex;
+  std::string m_deviceList;
+  uint64_t m_objectSize;
+  uint8_t m_bulkDataType;
+  bool m_useTemplate;
+
+private:
+  uint32_t m_poolSize;
+  std::vector<shared_ptr< ::ndn::Buffer>> m_pool;
+  size_t m_poolNext;
+
+  std::vector<uint8_t> m_template;
+  size_t m_contentOffset;
+  std::vector<Device> m_devices;
+  std::shared_ptr<const HealthSampleStore> m_samples;
+  shared_ptr< ::ndn::Buffer> m_segmentContent;
+
+  ::ndn::security::SigningInfo m_signingInfo;
+  Signature m_cachedSignature;
+  Time m_cpuBusyUntil;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(HealthProducerExt);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_PRODUCER_EXT_HPP
@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-profiling-scheduler.hpp
+
+#ifndef HEALTH_PROFILING_SCHEDULER_HPP
+#define HEALTH_PROFILING_SCHEDULER_HPP
+
+#include "ns3/event-impl.h"
+#include "ns3/fatal-error.h"
+#include "ns3/object-factory.h"
+#include "ns3/scheduler.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include <cxxabi.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Scheduler decorator that attributes wall time to event types
+ *
+ * Forwards everything to the `Inner` scheduler (ns3::MapScheduler by default).
+ * Every time the simulator takes the next event, the cycles since it took the
+ * previous one (that event's handler plus the scheduling it caused) are added to
+ * the previous event's tag: the dynamic type of its EventImpl and its context,
+ * i.e. the node it runs on.  The cost per event is one cycle counter read and one
+ * hash table update.
+ *
+ * The EventImpl type is the MakeEvent() instantiation, so it names the handler's
+ * class and signature (e.g. `void (ns3::ndn::ConsumerCbr::*)()`) but not the
+ * member function itself: handlers of one class with the same signature share a
+ * line.  Free functions are told apart only by their signature as well.
+ *
+ * When the simulator is destroyed, the totals are written to `ReportFile` sorted
+ * by time, first per event type over all nodes and then per event type and node.
+ *
+ *     ObjectFactory scheduler("ns3::ndn::ProfilingScheduler");
+ *     Simulator::SetScheduler(scheduler);
+ */
+class ProfilingScheduler : public Scheduler {
+public:
+  static TypeId
+  GetTypeId()
+  {
+    static TypeId tid =
+      TypeId("ns3::ndn::ProfilingScheduler")
+        .SetParent<Scheduler>()
+        .SetGroupName("Ndn")
+        .AddConstructor<ProfilingScheduler>()
+        .AddAttribute("Inner", "Type of the scheduler that orders the events",
+                      StringValue("ns3::MapScheduler"),
+                      MakeStringAccessor(&ProfilingScheduler::SetInner, &ProfilingScheduler::GetInner),
+                      MakeStringChecker())
+        .AddAttribute("ReportFile", "File the profile is written to when the simulator is destroyed",
+                      StringValue("event-profile.txt"),
+                      MakeStringAccessor(&ProfilingScheduler::m_reportFile), MakeStringChecker())
+        .AddAttribute("MaxReportLines", "Maximum number of per-node lines in the report",
+                      UintegerValue(100), MakeUintegerAccessor(&ProfilingScheduler::m_maxLines),
+                      MakeUintegerChecker<uint32_t>());
+
+    return tid;
+  }
+
+  ProfilingScheduler()
+    : m_reportFile("event-profile.txt")
+    , m_maxLines(100)
+    , m_current(nullptr)
+    , m_lastCycles(0)
+    , m_firstCycles(0)
+  {
+    SetInner("ns3::MapScheduler");
+  }
+
+  virtual ~ProfilingScheduler()
+  {
+    if (m_current != nullptr) {
+      WriteReport();
+    }
+  }
+
+  virtual void
+  Insert(const Event& ev)
+  {
+    m_inner->Insert(ev);
+  }
+
+  virtual bool
+  IsEmpty() const
+  {
+    return m_inner->IsEmpty();
+  }
+
+  virtual Event
+  PeekNext() const
+  {
+    return m_inner->PeekNext();
+  }
+
+  virtual Event
+  RemoveNext()
+  {
+    uint64_t now = ReadCycles();
+    if (m_current != nullptr) {
+      m_current->cycles += now - m_lastCycles;
+    }
+    else {
+      m_firstCycles = now;
+      m_firstWall = std::chrono::steady_clock::now();
+    }
+    m_lastCycles = now;
+
+    Event ev = m_inner->RemoveNext();
+
+    Tag tag = {&typeid(*ev.impl), ev.key.m_context};
+    Counter& counter = m_counters[tag];
+    ++counter.count;
+    m_current = &counter;
+    return ev;
+  }
+
+  virtual void
+  Remove(const Event& ev)
+  {
+    m_inner->Remove(ev);
+  }
+
+private:
+  static const uint32_t NO_CONTEXT = 0xffffffff; ///< same value as Simulator::NO_CONTEXT
+
+  struct Tag {
+    const std::type_info* type;
+    uint32_t context;
+
+    bool
+    operator==(const Tag& other) const
+    {
+      return type == other.type && context == other.context;
+    }
+  };
+
+  struct TagHash {
+    size_t
+    operator()(const Tag& tag) const
+    {
+      return std::hash<const void*>()(tag.type) * 31 + tag.context;
+    }
+  };
+
+  struct Counter {
+    uint64_t count = 0;
+    uint64_t cycles = 0;
+  };
+
+  struct Line {
+    std::string type;
+    uint32_t context;
+    uint64_t count;
+    uint64_t cycles;
+  };
+
+  static uint64_t
+  ReadCycles()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  static std::string
+  Demangle(const std::type_info* type)
+  {
+    int status = 0;
+    char* name = abi::__cxa_demangle(type->name(), nullptr, nullptr, &status);
+    std::string result = status == 0 && name != nullptr ? name : type->name();
+    std::free(name);
+    return result;
+  }
+
+  void
+  WriteReport()
+  {
+    // the last event is still running (or the simulation is over), so it gets no time
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_firstWall).count();
+    uint64_t cycles = ReadCycles() - m_firstCycles;
+    double secondsPerCycle = cycles > 0 ? wall / cycles : 0;
+
+    std::vector<Line> perNode;
+    std::unordered_map<std::string, Line> perType;
+    uint64_t totalCycles = 0;
+    uint64_t totalCount = 0;
+    for (const auto& entry : m_counters) {
+      Line line = {Demangle(entry.first.type), entry.first.context, entry.second.count,
+                   entry.second.cycles};
+      perNode.push_back(line);
+
+      Line& type = perType[line.type];
+      type.type = line.type;
+      type.context = NO_CONTEXT;
+      type.count += line.count;
+      type.cycles += line.cycles;
+
+      totalCycles += line.cycles;
+      totalCount += line.count;
+    }
+
+    std::vector<Line> types;
+    for (const auto& entry : perType) {
+      types.push_back(entry.second);
+    }
+
+    std::FILE* out = std::fopen(m_reportFile.c_str(), "w");
+    if (out == nullptr) {
+      NS_FATAL_ERROR("Cannot open event profile " << m_reportFile);
+    }
+    std::fprintf(out, "# %llu events, %.3f s wall time in event handlers and scheduling\n",
+                 static_cast<unsigned long long>(totalCount), totalCycles * secondsPerCycle);
+
+    std::fprintf(out, "\n# per event type (handler class and signature)\n"
+                      "Share\tSeconds\tCount\tNsPerEvent\tEventType\n");
+    WriteLines(out, types, totalCycles, secondsPerCycle, types.size(), false);
+
+    std::fprintf(out, "\n# per event type and node (context)\nShare\tSeconds\tCount\tNsPerEvent\tNode\tEventType\n");
+    WriteLines(out, perNode, totalCycles, secondsPerCycle, m_maxLines, true);
+
+    std::fclose(out);
+  }
+
+  static void
+  WriteLines(std::FILE* out, std::vector<Line>& lines, uint64_t totalCycles, double secondsPerCycle,
+             size_t maxLines, bool withNode)
+  {
+    std::sort(lines.begin(), lines.end(),
+              [](const Line& a, const Line& b) { return a.cycles > b.cycles; });
+
+    for (size_t i = 0; i < lines.size() && i < maxLines; ++i) {
+      const Line& line = lines[i];
+      double seconds = line.cycles * secondsPerCycle;
+      std::fprintf(out, "%.2f%%\t%.6f\t%llu\t%.0f\t", totalCycles > 0 ? 100.0 * line.cycles / totalCycles : 0.0,
+                   seconds, static_cast<unsigned long long>(line.count),
+                   line.count > 0 ? seconds * 1e9 / line.count : 0.0);
+      if (withNode && line.context != NO_CONTEXT) {
+        std::fprintf(out, "%u\t", line.context);
+      }
+      else if (withNode) {
+        std::fprintf(out, "-\t");
+      }
+      std::fprintf(out, "%s\n", line.type.c_str());
+    }
+  }
+
+  void
+  SetInner(std::string type)
+  {
+    if (m_inner != nullptr && !m_inner->IsEmpty()) {
+      NS_FATAL_ERROR("Cannot replace the inner scheduler once it holds events");
+    }
+
+    ObjectFactory factory;
+    factory.SetTypeId(type);
+    m_inner = factory.Create<Scheduler>();
+    m_innerType = type;
+  }
+
+  std::string
+  GetInner() const
+  {
+    return m_innerType;
+  }
+
+private:
+  Ptr<Scheduler> m_inner;
+  std::string m_innerType;
+  std::string m_reportFile;
+  uint32_t m_maxLines;
+
+  std::unordered_map<Tag, Counter, TagHash> m_counters;
+  Counter* m_current; ///< counter of the event that is running
+  uint64_t m_lastCycles;
+  uint64_t m_firstCycles;
+  std::chrono::steady_clock::time_point m_firstWall;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ProfilingScheduler);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_PROFILING_SCHEDULER_HPP
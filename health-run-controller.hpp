@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-run-controller.hpp
+
+#ifndef HEALTH_RUN_CONTROLLER_HPP
+#define HEALTH_RUN_CONTROLLER_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Stops the simulation once delay and throughput have converged
+ *
+ * Replaces a fixed Simulator::Stop().  After `warmup`, the run is cut into batches
+ * of `batch` simulated time; per batch the controller records the mean full delay
+ * (FirstInterestDataDelay) and the number of Data per second received by all
+ * applications.  Once there are `minBatches` batches, the 95% confidence interval
+ * of each metric's mean is computed from the batch means, and the simulation stops
+ * when every half-width is within `precision` of its mean.  `maxTime` is a hard cap.
+ *
+ * Batch means are only a valid CI if the batches are close to independent: while
+ * the lag-1 autocorrelation of either metric's batch means is above 0.2, the batch
+ * length is doubled by merging adjacent batches, as long as `2 * minBatches` of
+ * them remain.
+ *
+ * The outcome (converged or capped, time, and each mean with its half-width) is
+ * printed to std::clog when the run stops.
+ */
+class RunController {
+public:
+  static void
+  Install(Time maxTime, Time batch = Seconds(1), double precision = 0.05, Time warmup = Seconds(0),
+          uint32_t minBatches = 10)
+  {
+    GetInstance().reset(new RunController(maxTime, batch, precision, warmup, minBatches));
+    RunController* controller = GetInstance().get();
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/FirstInterestDataDelay",
+                                  MakeCallback(&RunController::FirstInterestDataDelay, controller));
+
+    Simulator::ScheduleDestroy(&RunController::Destroy);
+  }
+
+  static void
+  Destroy()
+  {
+    GetInstance().reset();
+  }
+
+  ~RunController()
+  {
+    Simulator::Cancel(m_batchEvent);
+    if (!m_reported && GetCompleteBatches() > 0) {
+      Report("capped");
+    }
+  }
+
+private:
+  enum { DELAY = 0, THROUGHPUT = 1, N_METRICS = 2 };
+
+  RunController(Time maxTime, Time batch, double precision, Time warmup, uint32_t minBatches)
+    : m_batch(batch)
+    , m_precision(precision)
+    , m_minBatches(std::max<uint32_t>(minBatches, 2))
+    , m_batchLength(1)
+    , m_running(false)
+    , m_reported(false)
+  {
+    Simulator::Stop(maxTime);
+    m_batchEvent = Simulator::Schedule(warmup, &RunController::StartBatch, this);
+  }
+
+  static std::unique_ptr<RunController>&
+  GetInstance()
+  {
+    static std::unique_ptr<RunController> instance;
+    return instance;
+  }
+
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount)
+  {
+    if (m_running) {
+      m_delaySums.back() += delay.GetSeconds();
+      ++m_samples.back();
+    }
+  }
+
+  void
+  StartBatch()
+  {
+    m_delaySums.push_back(0);
+    m_samples.push_back(0);
+    m_running = true;
+    m_batchEvent = Simulator::Schedule(m_batch, &RunController::EndBatch, this);
+  }
+
+  void
+  EndBatch()
+  {
+    m_running = false;
+    if (HasConverged()) {
+      Report("converged");
+      Simulator::Stop();
+      return;
+    }
+    StartBatch();
+  }
+
+  bool
+  HasConverged()
+  {
+    ComputeMeans();
+    while (m_means[THROUGHPUT].size() >= 2 * m_minBatches
+           && (GetLag1Correlation(m_means[DELAY]) > 0.2 || GetLag1Correlation(m_means[THROUGHPUT]) > 0.2)) {
+      m_batchLength *= 2;
+      ComputeMeans();
+    }
+
+    for (int metric = 0; metric < N_METRICS; ++metric) {
+      double mean, halfWidth;
+      if (m_means[metric].size() < m_minBatches || !GetInterval(m_means[metric], mean, halfWidth)
+          || halfWidth > m_precision * std::fabs(mean)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \brief Batch means over the recorded base batches, m_batchLength of them per batch
+   *
+   * An incomplete batch at the end is left out.  A batch without samples says
+   * nothing about the delay, it only counts as zero throughput.
+   */
+  void
+  ComputeMeans()
+  {
+    m_means[DELAY].clear();
+    m_means[THROUGHPUT].clear();
+
+    size_t batches = GetCompleteBatches() / m_batchLength;
+    for (size_t batch = 0; batch < batches; ++batch) {
+      double delaySum = 0;
+      uint64_t samples = 0;
+      for (size_t i = batch * m_batchLength; i < (batch + 1) * m_batchLength; ++i) {
+        delaySum += m_delaySums[i];
+        samples += m_samples[i];
+      }
+
+      if (samples > 0) {
+        m_means[DELAY].push_back(delaySum / samples);
+      }
+      m_means[THROUGHPUT].push_back(samples / (m_batch.GetSeconds() * m_batchLength));
+    }
+  }
+
+  size_t
+  GetCompleteBatches() const
+  {
+    return m_samples.size() - (m_running ? 1 : 0);
+  }
+
+  static double
+  GetLag1Correlation(const std::vector<double>& means)
+  {
+    if (means.size() < 2) {
+      return 0;
+    }
+
+    double mean = 0;
+    for (double value : means) {
+      mean += value;
+    }
+    mean /= means.size();
+
+    double variance = 0;
+    double covariance = 0;
+    for (size_t i = 0; i < means.size(); ++i) {
+      variance += (means[i] - mean) * (means[i] - mean);
+      if (i + 1 < means.size()) {
+        covariance += (means[i] - mean) * (means[i + 1] - mean);
+      }
+    }
+    return variance > 0 ? covariance / variance : 0;
+  }
+
+  /**
+   * \brief Mean and 95% CI half-width (Student t) of the batch means
+   */
+  static bool
+  GetInterval(const std::vector<double>& means, double& mean, double& halfWidth)
+  {
+    size_t n = means.size();
+    if (n < 2) {
+      return false;
+    }
+
+    mean = 0;
+    for (double value : means) {
+      mean += value;
+    }
+    mean /= n;
+
+    double variance = 0;
+    for (double value : means) {
+      variance += (value - mean) * (value - mean);
+    }
+    variance /= n - 1;
+
+    // Cornish-Fisher expansion of the t quantile around z = 1.96
+    double z = 1.959964;
+    double df = static_cast<double>(n - 1);
+    double t = z + (z * z * z + z) / (4 * df)
+               + (5 * std::pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * df * df);
+    halfWidth = t * std::sqrt(variance / n);
+    return true;
+  }
+
+  void
+  Report(const char* outcome)
+  {
+    m_reported = true;
+    ComputeMeans();
+    std::clog << "RunController: " << outcome << " at " << Simulator::Now().GetSeconds() << " s, "
+              << m_means[THROUGHPUT].size() << " batches of " << m_batch.GetSeconds() * m_batchLength
+              << " s";
+
+    static const char* names[] = {"delay (s)", "Data/s"};
+    for (int metric = 0; metric < N_METRICS; ++metric) {
+      double mean, halfWidth;
+      if (GetInterval(m_means[metric], mean, halfWidth)) {
+        std::clog << ", " << names[metric] << " " << mean << " +- " << halfWidth;
+      }
+    }
+    std::clog << std::endl;
+  }
+
+private:
+  Time m_batch;
+  double m_precision;
+  uint32_t m_minBatches;
+  uint32_t m_batchLength; ///< base batches per batch mean
+  bool m_running;         ///< the last base batch is still being recorded
+
+  std::vector<double> m_delaySums; ///< seconds, per base batch
+  std::vector<uint64_t> m_samples; ///< per base batch
+  std::vector<double> m_means[N_METRICS];
+  EventId m_batchEvent;
+  bool m_reported;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_RUN_CONTROLLER_HPP
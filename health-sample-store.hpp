@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-sample-store.hpp
+
+#ifndef HEALTH_SAMPLE_STORE_HPP
+#define HEALTH_SAMPLE_STORE_HPP
+
+#include "ns3/fatal-error.h"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Read-only, memory-mapped store of per-device sample records
+ *
+ * File layout (all integers little endian):
+ *
+ *     offset  0  magic "HSMP"
+ *     offset  4  uint32 version (1)
+ *     offset  8  uint32 number of devices
+ *     offset 12  uint32 record size in bytes
+ *     offset 16  uint64 records per device
+ *     offset 24  records, device-major: record t of device d starts at
+ *                24 + (d * recordsPerDevice + t) * recordSize
+ *
+ * A record is one reply's worth of samples (e.g. an ECG, SpO2 or blood pressure
+ * window).  The file is mapped once per process and shared by every producer that
+ * opens the same path, so thousands of devices cost one mapping and the page cache
+ * does all the I/O.
+ */
+class HealthSampleStore {
+public:
+  static const size_t HEADER_SIZE = 24;
+
+  /**
+   * \brief Open (or reuse the existing mapping of) the sample file at @p path
+   */
+  static std::shared_ptr<const HealthSampleStore>
+  Open(const std::string& path)
+  {
+    static std::map<std::string, std::weak_ptr<const HealthSampleStore>> stores;
+
+    std::shared_ptr<const HealthSampleStore> store = stores[path].lock();
+    if (store == nullptr) {
+      store.reset(new HealthSampleStore(path));
+      stores[path] = store;
+    }
+    return store;
+  }
+
+  ~HealthSampleStore()
+  {
+    if (m_base != nullptr) {
+      munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+  }
+
+  uint32_t
+  GetDeviceCount() const
+  {
+    return m_deviceCount;
+  }
+
+  uint32_t
+  GetRecordSize() const
+  {
+    return m_recordSize;
+  }
+
+  uint64_t
+  GetRecordsPerDevice() const
+  {
+    return m_recordsPerDevice;
+  }
+
+  /**
+   * \brief Pointer into the mapping to record @p index of @p device
+   *
+   * The index wraps around, so a long run replays the series; a device the file
+   * does not have is a fatal error.
+   */
+  const uint8_t*
+  GetRecord(uint32_t device, uint64_t index) const
+  {
+    if (device >= m_deviceCount) {
+      NS_FATAL_ERROR("Sample device " << device << " is not in the file, which has " << m_deviceCount);
+    }
+    uint64_t record = static_cast<uint64_t>(device) * m_recordsPerDevice + index % m_recordsPerDevice;
+    return m_base + HEADER_SIZE + record * m_recordSize;
+  }
+
+private:
+  explicit HealthSampleStore(const std::string& path)
+    : m_base(nullptr)
+    , m_size(0)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      NS_FATAL_ERROR("Cannot open sample file " << path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+      close(fd);
+      NS_FATAL_ERROR("Sample file " << path << " is too short");
+    }
+    m_size = static_cast<size_t>(st.st_size);
+
+    void* base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      NS_FATAL_ERROR("Cannot map sample file " << path);
+    }
+    m_base = static_cast<const uint8_t*>(base);
+
+    if (std::memcmp(m_base, "HSMP", 4) != 0 || ReadLe(m_base + 4, 4) != 1) {
+      NS_FATAL_ERROR("Sample file " << path << " has an unknown format");
+    }
+    m_deviceCount = static_cast<uint32_t>(ReadLe(m_base + 8, 4));
+    m_recordSize = static_cast<uint32_t>(ReadLe(m_base + 12, 4));
+    m_recordsPerDevice = ReadLe(m_base + 16, 8);
+
+    // divided rather than multiplied out, which could overflow for a corrupt header
+    if (m_deviceCount == 0 || m_recordSize == 0 || m_recordsPerDevice == 0
+        || m_recordsPerDevice > (m_size - HEADER_SIZE) / m_recordSize / m_deviceCount) {
+      NS_FATAL_ERROR("Sample file " << path << " is truncated or empty");
+    }
+  }
+
+  static uint64_t
+  ReadLe(const uint8_t* pos, size_t size)
+  {
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i) {
+      value = (value << 8) | pos[i - 1];
+    }
+    return value;
+  }
+
+private:
+  const uint8_t* m_base;
+  size_t m_size;
+  uint32_t m_deviceCount;
+  uint32_t m_recordSize;
+  uint64_t m_recordsPerDevice;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_SAMPLE_STORE_HPP
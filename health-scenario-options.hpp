@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-scenario-options.hpp
+
+#ifndef HEALTH_SCENARIO_OPTIONS_HPP
+#define HEALTH_SCENARIO_OPTIONS_HPP
+
+#include "health-binary-delay-tracer.hpp"
+#include "health-calendar-scheduler.hpp"
+#include "health-columnar-delay-tracer.hpp"
+#include "health-counting-scheduler.hpp"
+#include "health-delay-histogram-tracer.hpp"
+#include "health-fork-runner.hpp"
+#include "health-link-tracer.hpp"
+#include "health-live-metrics.hpp"
+#include "health-memory-tracer.hpp"
+#include "health-profiling-scheduler.hpp"
+#include "health-run-controller.hpp"
+
+#include "ns3/ndnSIM/utils/tracers/ndn-app-delay-tracer.hpp"
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Tracing, scheduler and run-control options shared by all scenarios
+ *
+ * A scenario registers them next to its own options and, once the topology and
+ * the applications are set up, lets InstallInstrumentation() act on them:
+ *
+ *     ndn::ScenarioOptions options;
+ *     CommandLine cmd;
+ *     options.AddOptions(cmd);
+ *     cmd.Parse(argc, argv);
+ *     ...
+ *     if (!options.InstallInstrumentation(Seconds(50.0))) {
+ *       Simulator::Destroy();
+ *       return 0;
+ *     }
+ *     options.Run();
+ *     Simulator::Destroy();
+ */
+struct ScenarioOptions {
+  std::string delayTrace = "text";
+  std::string liveMetrics;
+  bool linkTrace = false;
+  bool profileEvents = false;
+  double memoryTrace = 0;
+  std::string scheduler = "ns3::MapScheduler";
+  bool benchmark = false;
+  uint32_t forkSeeds = 0;
+  double warmup = 10;
+  bool autoStop = false;
+  double precision = 0.05;
+
+  void
+  AddOptions(CommandLine& cmd)
+  {
+    cmd.AddValue("delayTrace",
+                 "App delay trace: text, binary (app-delays.bin), columnar (app-delays.col) "
+                 "or histogram (app-delay-histograms.txt)",
+                 delayTrace);
+    cmd.AddValue("liveMetrics", "Publish live counters to this file, e.g. /dev/shm/metrics (empty: off)",
+                 liveMetrics);
+    cmd.AddValue("linkTrace", "Trace queue occupancy, drops and utilization per link to link-queues.bin",
+                 linkTrace);
+    cmd.AddValue("profileEvents", "Write wall time per event type and node to event-profile.txt",
+                 profileEvents);
+    cmd.AddValue("memoryTrace", "Seconds between per-node table memory dumps to memory-usage.txt, 0 for none",
+                 memoryTrace);
+    cmd.AddValue("scheduler", "Event scheduler, e.g. ns3::ndn::CalendarQueueScheduler", scheduler);
+    cmd.AddValue("benchmark", "Print events per wall-clock second at the end of the run", benchmark);
+    cmd.AddValue("forkSeeds", "Fork this many seed runs (in seed-<i>/) after the warm-up, 0 for one plain run",
+                 forkSeeds);
+    cmd.AddValue("warmup",
+                 "Seconds simulated once before forking the seed runs; --autoStop also leaves them "
+                 "out of its batches",
+                 warmup);
+    cmd.AddValue("autoStop", "Stop once delay and throughput reach the target precision (at most the stop time)",
+                 autoStop);
+    cmd.AddValue("precision", "Target 95% CI half-width relative to the mean for --autoStop", precision);
+  }
+
+  /**
+   * \brief Select the scheduler, set up the stop time, --forkSeeds and the tracers
+   *
+   * @param stopTime end of the run (the cap with --autoStop)
+   * @returns false in the parent of forked seed runs, which has nothing left to run
+   */
+  bool
+  InstallInstrumentation(Time stopTime)
+  {
+    // the scheduler holds no threads, so it is selected before the warm-up and
+    // --profileEvents and --benchmark cover forked runs from the start
+    std::string inner = scheduler;
+    if (profileEvents) {
+      Config::SetDefault("ns3::ndn::ProfilingScheduler::Inner", StringValue(inner));
+      inner = "ns3::ndn::ProfilingScheduler";
+    }
+    if (benchmark || !liveMetrics.empty()) {
+      ObjectFactory factory("ns3::ndn::CountingScheduler");
+      factory.Set("Inner", StringValue(inner));
+      factory.Set("Report", BooleanValue(benchmark));
+      Simulator::SetScheduler(factory);
+    }
+    else {
+      Simulator::SetScheduler(ObjectFactory(inner));
+    }
+
+    if (autoStop) {
+      RunController::Install(stopTime, Seconds(1), precision, Seconds(warmup));
+    }
+    else {
+      Simulator::Stop(stopTime);
+    }
+
+    if (forkSeeds > 0) {
+      int child = ForkRunner::Fork(Seconds(warmup), forkSeeds);
+      if (child < 0) {
+        CountingScheduler::GetReportLabel() = " (warm-up only)";
+        return false;
+      }
+      CountingScheduler::GetReportLabel() = " (seed-" + std::to_string(child) + ", with the warm-up)";
+    }
+
+    if (delayTrace == "binary") {
+      BinaryDelayTracer::InstallAll("app-delays.bin");
+    }
+    else if (delayTrace == "columnar") {
+      ColumnarDelayTracer::InstallAll("app-delays.col");
+    }
+    else if (delayTrace == "histogram") {
+      DelayHistogramTracer::InstallAll("app-delay-histograms.txt", Seconds(10));
+    }
+    else {
+      AppDelayTracer::InstallAll("app-delays.txt");
+    }
+
+    if (memoryTrace > 0) {
+      MemoryTracer::InstallAll("memory-usage.txt", Seconds(memoryTrace));
+    }
+
+    if (linkTrace) {
+      LinkQueueTracer::InstallAll("link-queues.bin", Seconds(1));
+    }
+
+    // the publisher thread has to start after the fork
+    if (!liveMetrics.empty()) {
+      LiveMetrics::Install(liveMetrics, Seconds(1), 4096, "");
+    }
+    return true;
+  }
+
+  /**
+   * \brief Simulator::Run(), then the tracer output that needs the nodes
+   */
+  void
+  Run()
+  {
+    Simulator::Run();
+    if (memoryTrace > 0) {
+      MemoryTracer::Stop();
+    }
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_SCENARIO_OPTIONS_HPP
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// health-timer-wheel.hpp
+
+#ifndef HEALTH_TIMER_WHEEL_HPP
+#define HEALTH_TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Hierarchical timer wheel driven by an external periodic tick
+ *
+ * Four levels of 256 slots each cover 2^32 ticks; a deadline is filed in the
+ * lowest level whose current rotation contains it, and entries cascade one level
+ * down whenever the level below wraps.  Insert is O(1) and there is no cancel:
+ * owners tag entries (e.g. with a generation counter) and ignore stale ones when
+ * they expire, which is far cheaper than removing a timer that almost always gets
+ * cancelled because the Data arrived.
+ *
+ * Deadlines more than 2^32 - 1 ticks ahead are clamped to that horizon.
+ */
+template<typename T>
+class TimerWheel {
+public:
+  static const unsigned SLOT_BITS = 8;
+  static const size_t SLOTS = 1 << SLOT_BITS;
+  static const size_t LEVELS = 4;
+
+  TimerWheel()
+    : m_now(0)
+    , m_size(0)
+  {
+  }
+
+  /**
+   * \brief Current tick, i.e. the last tick passed to Advance()
+   */
+  uint64_t
+  GetNow() const
+  {
+    return m_now;
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * \brief File @p value to expire at tick @p deadline (at the next tick if already due)
+   */
+  void
+  Insert(uint64_t deadline, const T& value)
+  {
+    if (deadline <= m_now) {
+      deadline = m_now + 1;
+    }
+    if (deadline - m_now >= (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS))) {
+      deadline = m_now + (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+    File(deadline, value);
+  }
+
+  /**
+   * \brief Move the wheel forward to tick @p now, calling @p expired(value) for every
+   *        entry whose deadline has passed
+   */
+  template<typename Function>
+  void
+  Advance(uint64_t now, Function expired)
+  {
+    while (m_now < now) {
+      ++m_now;
+
+      for (size_t level = LEVELS - 1; level >= 1; --level) {
+        if ((m_now & ((static_cast<uint64_t>(1) << (SLOT_BITS * level)) - 1)) == 0) {
+          Cascade(level);
+        }
+      }
+
+      std::vector<Entry>& slot = m_slots[0][m_now & (SLOTS - 1)];
+      if (slot.empty()) {
+        continue;
+      }
+
+      m_expiring.clear();
+      m_expiring.swap(slot);
+      m_size -= m_expiring.size();
+      for (const Entry& entry : m_expiring) {
+        expired(entry.value);
+      }
+    }
+  }
+
+private:
+  /**
+   * \brief Put @p value into the slot of @p deadline, which must not be in the past
+   */
+  void
+  File(uint64_t deadline, const T& value)
+  {
+    size_t level = 0;
+    while (level + 1 < LEVELS
+           && (deadline >> (SLOT_BITS * (level + 1))) != (m_now >> (SLOT_BITS * (level + 1)))) {
+      ++level;
+    }
+
+    Entry entry = {deadline, value};
+    m_slots[level][(deadline >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(entry);
+    ++m_size;
+  }
+
+  void
+  Cascade(size_t level)
+  {
+    std::vector<Entry>& slot = m_slots[level][(m_now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    if (slot.empty()) {
+      return;
+    }
+
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    m_size -= entries.size();
+    for (const Entry& entry : entries) {
+      // a deadline equal to the current tick lands in the level-0 slot expired next
+      File(entry.deadline, entry.value);
+    }
+  }
+
+private:
+  struct Entry {
+    uint64_t deadline;
+    T value;
+  };
+
+  std::vector<Entry> m_slots[LEVELS][SLOTS];
+  std::vector<Entry> m_expiring;
+  uint64_t m_now;
+  size_t m_size;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // HEALTH_TIMER_WHEEL_HPP
@@ -0,0 +1,530 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// app-delay-stats.cpp
+
+// Summarizes the app-delays.txt files of a sweep.  Stand-alone, it does not link
+// against ns-3:
+//
+//     g++ -O2 -std=c++11 -pthread -o app-delay-stats tools/app-delay-stats.cpp
+//     ./app-delay-stats [-j threads] [-m map] run-*/app-delays.txt
+//
+// Every file is memory-mapped and cut into chunks at line boundaries; the chunks
+// of all files are parsed by a pool of threads (one per core by default) into
+// per-thread histograms that are merged at the end.  The FullDelay samples are
+// grouped by prefix and DiseaseRank, which the text trace does not carry: the
+// optional map file names them per application, one line each,
+//
+//     <Node> <AppId> <Prefix> <Rank>
+//
+// and applications without a line are grouped as "<Node>/<AppId>" with rank "-".
+// One table is printed, a line per run and group and then an `All` line per group
+// over all runs:
+//
+//     Run Prefix Rank Samples LossPct PerSecond P50US P90US P99US P999US MaxUS MeanUS
+//
+// Loss is the share of the sequence numbers between the lowest and highest one
+// received by each application that never got a FullDelay sample; PerSecond is
+// the sample rate over the time span of the run's trace.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * \brief Log-linear histogram, same bucketing as ndn::LogLinearHistogram
+ *        (health-delay-histogram-tracer.hpp)
+ */
+class Histogram {
+public:
+  static const unsigned SUB_BUCKET_BITS = 7;
+  static const uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+
+  Histogram()
+    : m_count(0)
+    , m_sum(0)
+    , m_min(std::numeric_limits<uint64_t>::max())
+    , m_max(0)
+  {
+  }
+
+  void
+  Record(uint64_t value)
+  {
+    size_t index = GetIndex(value);
+    if (index >= m_counts.size()) {
+      m_counts.resize(index + 1, 0);
+    }
+    ++m_counts[index];
+
+    ++m_count;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+  }
+
+  void
+  Add(const Histogram& other)
+  {
+    if (other.m_counts.size() > m_counts.size()) {
+      m_counts.resize(other.m_counts.size(), 0);
+    }
+    for (size_t index = 0; index < other.m_counts.size(); ++index) {
+      m_counts[index] += other.m_counts[index];
+    }
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  uint64_t
+  GetCount() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  GetMax() const
+  {
+    return m_max;
+  }
+
+  double
+  GetMean() const
+  {
+    return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / m_count;
+  }
+
+  uint64_t
+  GetQuantile(double quantile) const
+  {
+    if (m_count == 0) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(quantile * m_count + 0.5);
+    rank = std::min(std::max<uint64_t>(rank, 1), m_count);
+
+    uint64_t seen = 0;
+    for (size_t index = 0; index < m_counts.size(); ++index) {
+      seen += m_counts[index];
+      if (seen >= rank) {
+        return std::min(std::max(GetUpperBound(index), m_min), m_max);
+      }
+    }
+    return m_max;
+  }
+
+private:
+  static size_t
+  GetIndex(uint64_t value)
+  {
+    if (value < SUB_BUCKETS) {
+      return static_cast<size_t>(value);
+    }
+
+    unsigned shift = 0;
+    while ((value >> shift) >= SUB_BUCKETS) {
+      ++shift;
+    }
+    return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS
+                               + ((value >> shift) - HALF_SUB_BUCKETS));
+  }
+
+  static uint64_t
+  GetUpperBound(size_t index)
+  {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+
+    uint64_t shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t top = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+  }
+
+private:
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+/**
+ * \brief FullDelay samples of one application (or one group) in one run
+ */
+struct AppStats {
+  Histogram delays; ///< microseconds
+  uint64_t minSeq = std::numeric_limits<uint64_t>::max();
+  uint64_t maxSeq = 0;
+
+  void
+  Add(const AppStats& other)
+  {
+    delays.Add(other.delays);
+    minSeq = std::min(minSeq, other.minSeq);
+    maxSeq = std::max(maxSeq, other.maxSeq);
+  }
+
+  uint64_t
+  GetExpected() const
+  {
+    return delays.GetCount() == 0 ? 0 : maxSeq - minSeq + 1;
+  }
+};
+
+/**
+ * \brief What one thread parsed out of one chunk; keys are "<Node>\t<AppId>"
+ */
+struct ChunkResult {
+  std::unordered_map<std::string, AppStats> apps;
+  double firstTime = std::numeric_limits<double>::max();
+  double lastTime = std::numeric_limits<double>::lowest();
+};
+
+struct Chunk {
+  size_t file;
+  const char* begin;
+  const char* end;
+};
+
+class MappedFile {
+public:
+  MappedFile()
+    : m_base(nullptr)
+    , m_size(0)
+  {
+  }
+
+  ~MappedFile()
+  {
+    if (m_base != nullptr) {
+      munmap(const_cast<char*>(m_base), m_size);
+    }
+  }
+
+  bool
+  Open(const char* path)
+  {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      std::perror(path);
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      std::perror(path);
+      close(fd);
+      return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0) {
+      close(fd);
+      return true;
+    }
+
+    void* base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      std::perror(path);
+      return false;
+    }
+    m_base = static_cast<const char*>(base);
+    madvise(base, m_size, MADV_SEQUENTIAL);
+    return true;
+  }
+
+  /**
+   * \brief Cut the file into about @p count chunks that end at line boundaries
+   */
+  void
+  Split(size_t file, size_t count, std::vector<Chunk>& chunks) const
+  {
+    const char* begin = m_base;
+    const char* end = m_base + m_size;
+    size_t step = std::max<size_t>(m_size / std::max<size_t>(count, 1), 1 << 20);
+
+    while (begin < end) {
+      const char* cut = end - begin > static_cast<ptrdiff_t>(step) ? begin + step : end;
+      cut = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+      cut = cut == nullptr ? end : cut + 1;
+      chunks.push_back(Chunk{file, begin, cut});
+      begin = cut;
+    }
+  }
+
+private:
+  const char* m_base;
+  size_t m_size;
+};
+
+/**
+ * \brief Fields of one trace line; returns false for the header and malformed lines
+ *
+ * Columns: Time Node AppId SeqNo Type DelayS DelayUS RetxCount HopCount
+ */
+bool
+ParseLine(const char* line, const char* end, double& time, std::string& key, uint64_t& seq,
+          bool& full, uint64_t& delayUs)
+{
+  const char* fields[9];
+  const char* ends[9];
+  int count = 0;
+  const char* pos = line;
+  while (count < 9) {
+    while (pos < end && (*pos == ' ' || *pos == '\t')) {
+      ++pos;
+    }
+    if (pos == end) {
+      break;
+    }
+    fields[count] = pos;
+    while (pos < end && *pos != ' ' && *pos != '\t') {
+      ++pos;
+    }
+    ends[count++] = pos;
+  }
+  if (count < 7 || *fields[0] < '0' || *fields[0] > '9') {
+    return false;
+  }
+
+  char* parsed = nullptr;
+  time = std::strtod(fields[0], &parsed);
+  key.assign(fields[1], ends[1]);
+  key.push_back('\t');
+  key.append(fields[2], ends[2]);
+  seq = std::strtoull(fields[3], &parsed, 10);
+  full = ends[4] - fields[4] == 9 && std::memcmp(fields[4], "FullDelay", 9) == 0;
+  delayUs = std::strtoull(fields[6], &parsed, 10);
+  return true;
+}
+
+void
+ParseChunk(const Chunk& chunk, ChunkResult& result)
+{
+  std::string key;
+  const char* line = chunk.begin;
+  while (line < chunk.end) {
+    const char* end = static_cast<const char*>(std::memchr(line, '\n', chunk.end - line));
+    end = end == nullptr ? chunk.end : end;
+
+    double time;
+    uint64_t seq;
+    bool full;
+    uint64_t delayUs;
+    if (ParseLine(line, end, time, key, seq, full, delayUs)) {
+      result.firstTime = std::min(result.firstTime, time);
+      result.lastTime = std::max(result.lastTime, time);
+      if (full) {
+        AppStats& stats = result.apps[key];
+        stats.delays.Record(delayUs);
+        stats.minSeq = std::min(stats.minSeq, seq);
+        stats.maxSeq = std::max(stats.maxSeq, seq);
+      }
+    }
+    line = end + 1;
+  }
+}
+
+/**
+ * \brief "<Node>\t<AppId>" -> (prefix, rank) from the map file
+ */
+typedef std::map<std::string, std::pair<std::string, std::string>> GroupMap;
+
+bool
+ReadMap(const char* path, GroupMap& groups)
+{
+  std::ifstream is(path);
+  if (!is.is_open()) {
+    std::perror(path);
+    return false;
+  }
+
+  std::string node, app, prefix, rank;
+  while (is >> node) {
+    if (node[0] == '#') {
+      std::getline(is, node);
+      continue;
+    }
+    if (!(is >> app >> prefix >> rank)) {
+      std::fprintf(stderr, "%s: expected <Node> <AppId> <Prefix> <Rank>\n", path);
+      return false;
+    }
+    groups[node + "\t" + app] = std::make_pair(prefix, rank);
+  }
+  return true;
+}
+
+std::pair<std::string, std::string>
+GetGroup(const GroupMap& groups, const std::string& key)
+{
+  GroupMap::const_iterator group = groups.find(key);
+  if (group != groups.end()) {
+    return group->second;
+  }
+  std::string name = key;
+  name[name.find('\t')] = '/';
+  return std::make_pair(name, std::string("-"));
+}
+
+struct GroupStats {
+  AppStats total; ///< delays of all applications in the group
+  uint64_t expected = 0;
+  double seconds = 0;
+};
+
+void
+Print(const std::string& run, const std::pair<std::string, std::string>& group, const GroupStats& stats)
+{
+  const Histogram& delays = stats.total.delays;
+  double loss = stats.expected > 0 ? 100.0 * (stats.expected - delays.GetCount()) / stats.expected : 0;
+  std::printf("%s\t%s\t%s\t%llu\t%.3f\t%.3f\t%llu\t%llu\t%llu\t%llu\t%llu\t%.1f\n", run.c_str(),
+              group.first.c_str(), group.second.c_str(), static_cast<unsigned long long>(delays.GetCount()),
+              std::max(loss, 0.0), stats.seconds > 0 ? delays.GetCount() / stats.seconds : 0.0,
+              static_cast<unsigned long long>(delays.GetQuantile(0.5)),
+              static_cast<unsigned long long>(delays.GetQuantile(0.9)),
+              static_cast<unsigned long long>(delays.GetQuantile(0.99)),
+              static_cast<unsigned long long>(delays.GetQuantile(0.999)),
+              static_cast<unsigned long long>(delays.GetMax()), delays.GetMean());
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const char* mapFile = nullptr;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      threads = std::max(std::atoi(argv[++i]), 1);
+    }
+    else if (std::strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      mapFile = argv[++i];
+    }
+    else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty()) {
+    std::fprintf(stderr, "usage: %s [-j threads] [-m map] <app-delays.txt>...\n", argv[0]);
+    return 1;
+  }
+
+  GroupMap groupMap;
+  if (mapFile != nullptr && !ReadMap(mapFile, groupMap)) {
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<MappedFile>> files;
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    files.emplace_back(new MappedFile());
+    if (!files.back()->Open(paths[i])) {
+      return 1;
+    }
+    files.back()->Split(i, threads, chunks);
+  }
+
+  // biggest chunks first, so no thread is left with a large one at the end
+  std::sort(chunks.begin(), chunks.end(),
+            [](const Chunk& a, const Chunk& b) { return a.end - a.begin > b.end - b.begin; });
+
+  std::vector<ChunkResult> results(chunks.size());
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < std::min(threads, chunks.size()); ++i) {
+    pool.emplace_back([&] {
+      for (size_t chunk = next++; chunk < chunks.size(); chunk = next++) {
+        ParseChunk(chunks[chunk], results[chunk]);
+      }
+    });
+  }
+  for (std::thread& thread : pool) {
+    thread.join();
+  }
+
+  // per run and application, then per run and group
+  std::vector<ChunkResult> runs(paths.size());
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    ChunkResult& run = runs[chunks[i].file];
+    run.firstTime = std::min(run.firstTime, results[i].firstTime);
+    run.lastTime = std::max(run.lastTime, results[i].lastTime);
+    for (const auto& app : results[i].apps) {
+      run.apps[app.first].Add(app.second);
+    }
+  }
+  results.clear();
+
+  typedef std::map<std::pair<std::string, std::string>, GroupStats> Groups;
+  Groups all;
+  std::printf("Run\tPrefix\tRank\tSamples\tLossPct\tPerSecond\tP50US\tP90US\tP99US\tP999US\tMaxUS\tMeanUS\n");
+  for (size_t i = 0; i < runs.size(); ++i) {
+    double seconds = runs[i].lastTime > runs[i].firstTime ? runs[i].lastTime - runs[i].firstTime : 0;
+
+    Groups groups;
+    for (const auto& app : runs[i].apps) {
+      GroupStats& group = groups[GetGroup(groupMap, app.first)];
+      group.total.Add(app.second);
+      group.expected += app.second.GetExpected();
+      group.seconds = seconds;
+    }
+
+    for (const auto& group : groups) {
+      Print(paths[i], group.first, group.second);
+
+      GroupStats& total = all[group.first];
+      total.total.Add(group.second.total);
+      total.expected += group.second.expected;
+      total.seconds += group.second.seconds;
+    }
+  }
+
+  if (runs.size() > 1) {
+    for (const auto& group : all) {
+      Print("All", group.first, group.second);
+    }
+  }
+  return 0;
+}
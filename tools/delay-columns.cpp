@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// delay-columns.cpp
+
+// Reads ColumnarDelayTracer files (health-columnar-delay-tracer.hpp).  Stand-alone,
+// it does not link against ns-3:
+//
+//     g++ -O2 -std=c++11 -o delay-columns tools/delay-columns.cpp
+//     ./delay-columns text app-delays.col > app-delays.txt
+//     ./delay-columns stats run-*/app-delays.col
+//
+// `text` prints the ndn::AppDelayTracer text format.  `stats` prints the count, mean,
+// minimum and maximum full delay of each file, touching only the type and delay
+// columns of the memory-mapped file.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct RowGroup {
+  uint32_t rows;
+  const uint8_t* time; ///< varint deltas
+  const uint32_t* node;
+  const uint32_t* app;
+  const uint32_t* seq;
+  const uint8_t* type;
+  const int64_t* delay;
+  const uint32_t* retx;
+  const int32_t* hop;
+};
+
+class ColumnFile {
+public:
+  ColumnFile()
+    : m_base(nullptr)
+    , m_size(0)
+  {
+  }
+
+  ~ColumnFile()
+  {
+    if (m_base != nullptr) {
+      munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+  }
+
+  bool
+  Open(const char* path)
+  {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      std::perror(path);
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 20) {
+      close(fd);
+      std::fprintf(stderr, "%s: too short\n", path);
+      return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+
+    void* base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      std::perror(path);
+      return false;
+    }
+    m_base = static_cast<const uint8_t*>(base);
+
+    if (std::memcmp(m_base, "HCOL", 4) != 0 || Read<uint32_t>(4) != 1
+        || std::memcmp(m_base + m_size - 4, "HCOL", 4) != 0) {
+      std::fprintf(stderr, "%s: not a version 1 columnar delay trace\n", path);
+      return false;
+    }
+
+    uint64_t pos = Read<uint64_t>(m_size - 12);
+    uint32_t names = Read<uint32_t>(pos);
+    pos += 4;
+    for (uint32_t i = 0; i < names; ++i) {
+      uint32_t length = Read<uint32_t>(pos);
+      m_dictionary.push_back(std::string(reinterpret_cast<const char*>(m_base + pos + 4), length));
+      pos += 4 + length;
+    }
+
+    uint32_t groups = Read<uint32_t>(pos);
+    pos += 4;
+    for (uint32_t i = 0; i < groups; ++i) {
+      m_groups.push_back(ReadGroup(Read<uint64_t>(pos)));
+      pos += 12;
+    }
+    return true;
+  }
+
+  const std::vector<RowGroup>&
+  GetGroups() const
+  {
+    return m_groups;
+  }
+
+  const std::string&
+  GetNodeName(uint32_t code) const
+  {
+    return m_dictionary.at(code);
+  }
+
+private:
+  template<typename T>
+  T
+  Read(uint64_t pos) const
+  {
+    T value;
+    std::memcpy(&value, m_base + pos, sizeof(T));
+    return value;
+  }
+
+  RowGroup
+  ReadGroup(uint64_t pos) const
+  {
+    RowGroup group;
+    group.rows = Read<uint32_t>(pos);
+    uint32_t timeSize = Read<uint32_t>(pos + 4);
+    pos += 8;
+
+    group.time = Column<uint8_t>(pos, timeSize);
+    group.node = Column<uint32_t>(pos, group.rows);
+    group.app = Column<uint32_t>(pos, group.rows);
+    group.seq = Column<uint32_t>(pos, group.rows);
+    group.type = Column<uint8_t>(pos, group.rows);
+    group.delay = Column<int64_t>(pos, group.rows);
+    group.retx = Column<uint32_t>(pos, group.rows);
+    group.hop = Column<int32_t>(pos, group.rows);
+    return group;
+  }
+
+  /**
+   * \brief Pointer to the column of @p count values at the next 8-byte boundary after @p pos
+   */
+  template<typename T>
+  const T*
+  Column(uint64_t& pos, uint64_t count) const
+  {
+    pos = (pos + 7) / 8 * 8;
+    const T* column = reinterpret_cast<const T*>(m_base + pos);
+    pos += count * sizeof(T);
+    return column;
+  }
+
+private:
+  const uint8_t* m_base;
+  size_t m_size;
+  std::vector<std::string> m_dictionary;
+  std::vector<RowGroup> m_groups;
+};
+
+void
+PrintText(const ColumnFile& file)
+{
+  std::printf("Time\tNode\tAppId\tSeqNo\tType\tDelayS\tDelayUS\tRetxCount\tHopCount\n");
+
+  for (const RowGroup& group : file.GetGroups()) {
+    const uint8_t* time = group.time;
+    uint64_t now = 0;
+    for (uint32_t row = 0; row < group.rows; ++row) {
+      uint64_t delta = 0;
+      for (unsigned shift = 0;; shift += 7) {
+        uint8_t byte = *time++;
+        delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+          break;
+        }
+      }
+      now += delta;
+
+      std::printf("%g\t%s\t%u\t%u\t%s\t%g\t%g\t%u\t%d\n", now / 1e9,
+                  file.GetNodeName(group.node[row]).c_str(), group.app[row], group.seq[row],
+                  group.type[row] == 0 ? "LastDelay" : "FullDelay", group.delay[row] / 1e9,
+                  group.delay[row] / 1e3, group.retx[row], group.hop[row]);
+    }
+  }
+}
+
+void
+PrintStats(const char* path, const ColumnFile& file)
+{
+  uint64_t count = 0;
+  double sum = 0;
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = 0;
+
+  for (const RowGroup& group : file.GetGroups()) {
+    for (uint32_t row = 0; row < group.rows; ++row) {
+      if (group.type[row] == 1) {
+        ++count;
+        sum += group.delay[row];
+        min = std::min(min, group.delay[row]);
+        max = std::max(max, group.delay[row]);
+      }
+    }
+  }
+
+  std::printf("%s\t%llu\t%g\t%g\t%g\n", path, static_cast<unsigned long long>(count),
+              count == 0 ? 0.0 : sum / count / 1e9, count == 0 ? 0.0 : min / 1e9, max / 1e9);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string mode = argc > 1 ? argv[1] : "";
+  if (argc < 3 || (mode != "text" && mode != "stats") || (mode == "text" && argc != 3)) {
+    std::fprintf(stderr, "usage: %s text <trace>\n       %s stats <trace>...\n", argv[0], argv[0]);
+    return 1;
+  }
+
+  if (mode == "stats") {
+    std::printf("File\tCount\tMeanS\tMinS\tMaxS\n");
+  }
+
+  for (int i = 2; i < argc; ++i) {
+    ColumnFile file;
+    if (!file.Open(argv[i])) {
+      return 1;
+    }
+
+    if (mode == "text") {
+      PrintText(file);
+    }
+    else {
+      PrintStats(argv[i], file);
+    }
+  }
+  return 0;
+}
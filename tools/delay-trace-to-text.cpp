@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// delay-trace-to-text.cpp
+
+// Converts a BinaryDelayTracer trace (health-binary-delay-tracer.hpp) into the text
+// format of ndn::AppDelayTracer.  Stand-alone, it does not link against ns-3:
+//
+//     g++ -O2 -std=c++11 -o delay-trace-to-text tools/delay-trace-to-text.cpp
+//     ./delay-trace-to-text app-delays.bin > app-delays.txt
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// must match ns3::ndn::DelayRecord
+struct DelayRecord {
+  int64_t time;
+  int64_t delay;
+  uint32_t node;
+  uint32_t appId;
+  uint32_t seq;
+  uint32_t retxCount;
+  int32_t hopCount;
+  uint8_t type;
+  uint8_t reserved[3];
+};
+
+bool
+ReadAll(std::FILE* in, void* buffer, size_t size)
+{
+  return std::fread(buffer, 1, size, in) == size;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <binary delay trace>\n", argv[0]);
+    return 1;
+  }
+
+  std::FILE* in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  uint32_t header[4];
+  if (!ReadAll(in, header, sizeof(header)) || std::memcmp(header, "HDLY", 4) != 0 || header[1] != 1
+      || header[2] != sizeof(DelayRecord)) {
+    std::fprintf(stderr, "%s: not a version 1 binary delay trace\n", argv[1]);
+    return 1;
+  }
+
+  std::map<uint32_t, std::string> nodes;
+  for (uint32_t i = 0; i < header[3]; ++i) {
+    uint32_t entry[2];
+    if (!ReadAll(in, entry, sizeof(entry))) {
+      std::fprintf(stderr, "%s: truncated node table\n", argv[1]);
+      return 1;
+    }
+    std::string name(entry[1], '\0');
+    if (entry[1] > 0 && !ReadAll(in, &name[0], entry[1])) {
+      std::fprintf(stderr, "%s: truncated node table\n", argv[1]);
+      return 1;
+    }
+    nodes[entry[0]] = name.empty() ? std::to_string(entry[0]) : name;
+  }
+
+  std::printf("Time\tNode\tAppId\tSeqNo\tType\tDelayS\tDelayUS\tRetxCount\tHopCount\n");
+
+  std::vector<DelayRecord> records(64 * 1024);
+  size_t count;
+  while ((count = std::fread(&records[0], sizeof(DelayRecord), records.size(), in)) > 0) {
+    for (size_t i = 0; i < count; ++i) {
+      const DelayRecord& record = records[i];
+      auto node = nodes.find(record.node);
+      std::string nodeName = node != nodes.end() ? node->second : std::to_string(record.node);
+
+      std::printf("%g\t%s\t%u\t%u\t%s\t%g\t%g\t%u\t%d\n", record.time / 1e9, nodeName.c_str(),
+                  record.appId, record.seq, record.type == 0 ? "LastDelay" : "FullDelay",
+                  record.delay / 1e9, record.delay / 1e3, record.retxCount, record.hopCount);
+    }
+  }
+
+  std::fclose(in);
+  return 0;
+}
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// link-trace-to-text.cpp
+
+// Prints a LinkQueueTracer trace (health-link-tracer.hpp).  Stand-alone, it does not
+// link against ns-3:
+//
+//     g++ -O2 -std=c++11 -o link-trace-to-text tools/link-trace-to-text.cpp
+//     ./link-trace-to-text link-queues.bin            # per-link summary, worst first
+//     ./link-trace-to-text link-queues.bin records    # every per-period record
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// must match ns3::ndn::LinkRecord and LinkQueueTracer::QUEUE_BUCKETS
+struct LinkRecord {
+  int64_t time;
+  uint32_t link;
+  uint32_t maxQueue;
+  double meanQueue;
+  double utilization;
+  uint32_t enqueues;
+  uint32_t dequeues;
+  uint32_t drops[3];
+  uint32_t reserved;
+};
+
+const uint32_t QUEUE_BUCKETS = 64;
+
+struct LinkSummary {
+  std::string name;
+  uint32_t limit;
+  uint64_t dataRate;
+  uint64_t periods;
+  uint64_t enqueues;
+  uint64_t drops[3];
+  uint32_t maxQueue;
+  double meanQueue;
+  double utilization;
+  double peakUtilization;
+  std::vector<uint64_t> histogram;
+};
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  bool records = argc == 3 && std::string(argv[2]) == "records";
+  if (argc != 2 && !records) {
+    std::fprintf(stderr, "usage: %s <link trace> [records]\n", argv[0]);
+    return 1;
+  }
+
+  std::FILE* in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  uint32_t header[4];
+  if (std::fread(header, sizeof(header), 1, in) != 1 || std::memcmp(header, "HLNK", 4) != 0
+      || header[1] != 1 || header[2] != sizeof(LinkRecord)) {
+    std::fprintf(stderr, "%s: not a version 1 link trace\n", argv[1]);
+    return 1;
+  }
+
+  std::vector<LinkSummary> links(header[3]);
+  for (LinkSummary& link : links) {
+    uint32_t nameLength = 0;
+    if (std::fread(&link.limit, sizeof(uint32_t), 1, in) != 1
+        || std::fread(&link.dataRate, sizeof(uint64_t), 1, in) != 1
+        || std::fread(&nameLength, sizeof(uint32_t), 1, in) != 1) {
+      std::fprintf(stderr, "%s: truncated link table\n", argv[1]);
+      return 1;
+    }
+    link.name.resize(nameLength);
+    if (nameLength > 0 && std::fread(&link.name[0], 1, nameLength, in) != nameLength) {
+      std::fprintf(stderr, "%s: truncated link table\n", argv[1]);
+      return 1;
+    }
+  }
+
+  // records up to the footer, whose size is known
+  long start = std::ftell(in);
+  std::fseek(in, 0, SEEK_END);
+  long footer = static_cast<long>(links.size() * QUEUE_BUCKETS * sizeof(uint64_t) + 4);
+  long recordCount = (std::ftell(in) - start - footer) / static_cast<long>(sizeof(LinkRecord));
+  std::fseek(in, start, SEEK_SET);
+
+  if (records) {
+    std::printf("Time\tLink\tMaxQueue\tMeanQueue\tUtilization\tEnqueues\tDequeues\t"
+                "InterestDrops\tDataDrops\tOtherDrops\n");
+  }
+
+  for (long i = 0; i < recordCount; ++i) {
+    LinkRecord record;
+    if (std::fread(&record, sizeof(record), 1, in) != 1 || record.link >= links.size()) {
+      std::fprintf(stderr, "%s: corrupt record %ld\n", argv[1], i);
+      return 1;
+    }
+
+    LinkSummary& link = links[record.link];
+    if (records) {
+      std::printf("%g\t%s\t%u\t%.3f\t%.4f\t%u\t%u\t%u\t%u\t%u\n", record.time / 1e9, link.name.c_str(),
+                  record.maxQueue, record.meanQueue, record.utilization, record.enqueues, record.dequeues,
+                  record.drops[0], record.drops[1], record.drops[2]);
+    }
+
+    ++link.periods;
+    link.enqueues += record.enqueues;
+    for (int j = 0; j < 3; ++j) {
+      link.drops[j] += record.drops[j];
+    }
+    link.maxQueue = std::max(link.maxQueue, record.maxQueue);
+    link.meanQueue += record.meanQueue;
+    link.utilization += record.utilization;
+    link.peakUtilization = std::max(link.peakUtilization, record.utilization);
+  }
+
+  for (LinkSummary& link : links) {
+    link.histogram.resize(QUEUE_BUCKETS);
+    if (std::fread(&link.histogram[0], sizeof(uint64_t), QUEUE_BUCKETS, in) != QUEUE_BUCKETS) {
+      std::fprintf(stderr, "%s: missing queue histograms (run not finished?)\n", argv[1]);
+      return 1;
+    }
+  }
+  std::fclose(in);
+
+  if (records) {
+    return 0;
+  }
+
+  std::sort(links.begin(), links.end(), [](const LinkSummary& a, const LinkSummary& b) {
+    uint64_t dropsA = a.drops[0] + a.drops[1] + a.drops[2];
+    uint64_t dropsB = b.drops[0] + b.drops[1] + b.drops[2];
+    return dropsA != dropsB ? dropsA > dropsB : a.utilization > b.utilization;
+  });
+
+  std::printf("Link\tLimit\tRateMbps\tEnqueues\tInterestDrops\tDataDrops\tOtherDrops\tMaxQueue\t"
+              "MeanQueue\tP99Queue\tMeanUtil\tPeakUtil\n");
+  for (const LinkSummary& link : links) {
+    uint64_t total = 0;
+    for (uint64_t count : link.histogram) {
+      total += count;
+    }
+    uint32_t p99 = 0;
+    for (uint64_t seen = 0; p99 < QUEUE_BUCKETS && total > 0; ++p99) {
+      seen += link.histogram[p99];
+      if (seen * 100 >= total * 99) {
+        break;
+      }
+    }
+
+    double periods = link.periods > 0 ? static_cast<double>(link.periods) : 1.0;
+    std::printf("%s\t%u\t%g\t%llu\t%llu\t%llu\t%llu\t%u\t%.3f\t%u\t%.4f\t%.4f\n", link.name.c_str(),
+                link.limit, link.dataRate / 1e6, static_cast<unsigned long long>(link.enqueues),
+                static_cast<unsigned long long>(link.drops[0]), static_cast<unsigned long long>(link.drops[1]),
+                static_cast<unsigned long long>(link.drops[2]), link.maxQueue, link.meanQueue / periods, p99,
+                link.utilization / periods, link.peakUtilization);
+  }
+  return 0;
+}
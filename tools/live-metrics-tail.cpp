@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// live-metrics-tail.cpp
+
+// Follows the shared-memory counters published by LiveMetrics (health-live-metrics.hpp)
+// and prints one line per record with per-second rates.  Stand-alone, it does not
+// link against ns-3:
+//
+//     g++ -O2 -std=c++11 -pthread -o live-metrics-tail tools/live-metrics-tail.cpp
+//     ./live-metrics-tail /dev/shm/c30p3-metrics
+//
+// It exits once the simulation has written its final record.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// must match ns3::ndn::LiveMetricsHeader and ns3::ndn::LiveMetricsRecord
+struct LiveMetricsHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t slots;
+  uint32_t recordSize;
+  int32_t pid;
+  std::atomic<uint32_t> finished;
+  std::atomic<uint64_t> published;
+};
+
+struct LiveMetricsRecord {
+  std::atomic<uint64_t> sequence;
+  double wallTime;
+  double simTime;
+  uint64_t interests;
+  uint64_t datas;
+  uint64_t timeouts;
+  uint64_t retransmissions;
+  uint64_t drops;
+  uint64_t events;
+  double simPerWall;
+  double eventsPerSecond;
+};
+
+struct Snapshot {
+  double wallTime;
+  double simTime;
+  uint64_t interests;
+  uint64_t datas;
+  uint64_t timeouts;
+  uint64_t retransmissions;
+  uint64_t drops;
+  double simPerWall;
+  double eventsPerSecond;
+};
+
+/**
+ * \brief Copy record @p n out of its slot; false if the writer has overwritten it
+ */
+bool
+ReadRecord(const LiveMetricsHeader* header, const LiveMetricsRecord* records, uint64_t n, Snapshot& out)
+{
+  const LiveMetricsRecord& record = records[n % header->slots];
+  if (record.sequence.load(std::memory_order_acquire) != 2 * n + 2) {
+    return false;
+  }
+
+  out.wallTime = record.wallTime;
+  out.simTime = record.simTime;
+  out.interests = record.interests;
+  out.datas = record.datas;
+  out.timeouts = record.timeouts;
+  out.retransmissions = record.retransmissions;
+  out.drops = record.drops;
+  out.simPerWall = record.simPerWall;
+  out.eventsPerSecond = record.eventsPerSecond;
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return record.sequence.load(std::memory_order_relaxed) == 2 * n + 2;
+}
+
+double
+Rate(uint64_t now, uint64_t before, double elapsed)
+{
+  return elapsed > 0 ? (now - before) / elapsed : 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <live metrics file>\n", argv[0]);
+    return 1;
+  }
+
+  int fd = open(argv[1], O_RDONLY);
+  if (fd < 0) {
+    std::perror(argv[1]);
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(LiveMetricsHeader)) {
+    std::fprintf(stderr, "%s: too short\n", argv[1]);
+    return 1;
+  }
+  void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  const LiveMetricsHeader* header = static_cast<const LiveMetricsHeader*>(base);
+  if (std::memcmp(header->magic, "HLIV", 4) != 0 || header->version != 2
+      || header->recordSize != sizeof(LiveMetricsRecord)) {
+    std::fprintf(stderr, "%s: not a version 2 live metrics file\n", argv[1]);
+    return 1;
+  }
+  const LiveMetricsRecord* records = reinterpret_cast<const LiveMetricsRecord*>(header + 1);
+
+  std::printf("# pid %d\n", header->pid);
+  std::printf("WallS\tSimS\tSimPerWall\tEventsPerS\tInterestsPerS\tDatasPerS\tTimeoutsPerS\tRetxPerS\tDropsPerS\n");
+
+  uint64_t next = 0;
+  Snapshot last = Snapshot();
+  for (;;) {
+    bool finished = header->finished.load(std::memory_order_acquire) != 0;
+    uint64_t published = header->published.load(std::memory_order_acquire);
+    if (published > next + header->slots) {
+      next = published - header->slots; // fell behind by a whole ring
+    }
+
+    for (; next < published; ++next) {
+      Snapshot record;
+      if (!ReadRecord(header, records, next, record)) {
+        continue;
+      }
+
+      double elapsed = record.wallTime - last.wallTime;
+      std::printf("%.1f\t%.3f\t%.3f\t%.0f\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f\n", record.wallTime, record.simTime,
+                  record.simPerWall, record.eventsPerSecond, Rate(record.interests, last.interests, elapsed),
+                  Rate(record.datas, last.datas, elapsed), Rate(record.timeouts, last.timeouts, elapsed),
+                  Rate(record.retransmissions, last.retransmissions, elapsed), Rate(record.drops, last.drops, elapsed));
+      std::fflush(stdout);
+      last = record;
+    }
+
+    if (finished) {
+      return 0;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  }
+}
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// scheduler-replay.cpp
+
+// Replays synthetic event streams through CalendarQueueScheduler
+// (health-calendar-scheduler.hpp) and ns-3's MapScheduler, outside a simulation.
+// Built against the headers and the core library of an ns-3 build in $NS3:
+//
+//     g++ -O2 -std=c++11 -I. -I$NS3/build -L$NS3/build -o scheduler-replay tools/scheduler-replay.cpp -lns3-dev-core-optimized
+//     ./scheduler-replay [operations]
+//
+// `check` replays a random mix of inserts, removals of the next event and cancels
+// of pending events through both schedulers and fails on the first event they
+// order differently.  `hold` then keeps 1k and 100k events pending and times
+// remove-next plus insert pairs, with delays like periodic consumers (200 ms and
+// a little jitter) and fixed 10 ms links.  This is a micro-benchmark of the queue
+// alone; whole scenarios are compared with --scheduler and --benchmark.
+
+#include "health-calendar-scheduler.hpp"
+
+#include "ns3/map-scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <random>
+
+using namespace ns3;
+
+namespace {
+
+const uint64_t MS = 1000000; // time steps per millisecond, at the default ns resolution
+
+Scheduler::Event
+MakeEvent(uint64_t ts, uint32_t uid)
+{
+  Scheduler::Event event;
+  event.impl = nullptr;
+  event.key.m_ts = ts;
+  event.key.m_uid = uid;
+  event.key.m_context = 0;
+  return event;
+}
+
+/**
+ * \brief Random inserts, removals and cancels through both schedulers; false on a mismatch
+ */
+bool
+Check(uint64_t operations)
+{
+  std::mt19937_64 rng(1);
+  ndn::CalendarQueueScheduler calendar;
+  MapScheduler reference;
+  std::map<uint32_t, Scheduler::Event> pending; // by uid, i.e. in insertion order
+  uint64_t now = 0;
+  uint32_t uid = 0;
+
+  for (uint64_t i = 0; i < operations; ++i) {
+    int op = rng() % 10;
+    if (op < 5 || reference.IsEmpty()) {
+      uint64_t delay = rng() % 3 == 0 ? 10 * MS : (rng() % 2 ? 200 * MS : rng() % MS);
+      if (rng() % 1000 == 0) {
+        delay = 50000 * MS; // a far-future event, beyond a whole bucket pass
+      }
+      Scheduler::Event event = MakeEvent(now + delay, uid++);
+      calendar.Insert(event);
+      reference.Insert(event);
+      pending[event.key.m_uid] = event;
+    }
+    else if (op < 9) {
+      Scheduler::Event peeked = calendar.PeekNext();
+      Scheduler::Event next = calendar.RemoveNext();
+      Scheduler::Event expected = reference.RemoveNext();
+      if (peeked.key.m_uid != expected.key.m_uid || next.key.m_uid != expected.key.m_uid) {
+        std::fprintf(stderr, "check: operation %llu removed uid %u, expected %u\n",
+                     static_cast<unsigned long long>(i), next.key.m_uid, expected.key.m_uid);
+        return false;
+      }
+      pending.erase(next.key.m_uid);
+      now = next.key.m_ts;
+    }
+    else {
+      // cancel one of the 50 most recently inserted events that are still pending
+      auto cancelled = pending.rbegin();
+      std::advance(cancelled, rng() % std::min<size_t>(pending.size(), 50));
+      Scheduler::Event event = cancelled->second;
+      pending.erase(event.key.m_uid);
+      calendar.Remove(event);
+      reference.Remove(event);
+    }
+
+    if (calendar.IsEmpty() != reference.IsEmpty()) {
+      std::fprintf(stderr, "check: operation %llu disagrees on emptiness\n",
+                   static_cast<unsigned long long>(i));
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Remove-next plus insert pairs per second with @p size events pending
+ */
+double
+Hold(Scheduler& scheduler, size_t size, uint64_t operations)
+{
+  std::mt19937_64 rng(2);
+  uint32_t uid = 0;
+  for (size_t i = 0; i < size; ++i) {
+    scheduler.Insert(MakeEvent(rng() % (200 * MS), uid++));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < operations; ++i) {
+    Scheduler::Event next = scheduler.RemoveNext();
+    uint64_t delay = i % 3 == 0 ? 10 * MS : 200 * MS + rng() % 1000;
+    scheduler.Insert(MakeEvent(next.key.m_ts + delay, uid++));
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  while (!scheduler.IsEmpty()) {
+    scheduler.RemoveNext();
+  }
+  return operations / seconds;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  uint64_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+  if (!Check(operations)) {
+    return 1;
+  }
+  std::printf("check\t%llu operations\tok\n", static_cast<unsigned long long>(operations));
+
+  std::printf("hold\tPending\tCalendarEventsPerS\tMapEventsPerS\n");
+  for (size_t size : {static_cast<size_t>(1000), static_cast<size_t>(100000)}) {
+    ndn::CalendarQueueScheduler calendar;
+    MapScheduler map;
+    double calendarRate = Hold(calendar, size, operations);
+    double mapRate = Hold(map, size, operations);
+    std::printf("hold\t%zu\t%.0f\t%.0f\n", size, calendarRate, mapRate);
+  }
+  return 0;
+}